@@ -1,9 +1,21 @@
+#include "../fields/boolean.h"
+#include "../fields/dynamic_modular.h"
+#include "../fields/dynamic_modular64.h"
 #include "../fields/rational.h"
 #include "../fields/modular.h"
+#include "../fields/row_kernels.h"
+#include "../library/fraction_free.h"
 #include "../library/ideal.h"
+#include "../library/modular_basis.h"
+#include "../parser/loader.h"
 
+#include <chrono>
+#include <cstdio>
+#include <fstream>
 #include <iostream>
 #include <ctime>
+#include <random>
+#include <string>
 
 using namespace math;
 using namespace polynomial;
@@ -11,8 +23,9 @@ using namespace std;
 
 #define TIME (clock() * 1.0 / CLOCKS_PER_SEC)
 
-Polynomial<Rational> get_sigma(int n, int k) {
-    Polynomial<Rational> result;
+template <class Compare, template <class, class> class Terms = MapTerms>
+Polynomial<Rational, Compare, Terms> get_sigma(int n, int k) {
+    Polynomial<Rational, Compare, Terms> result;
     for (int mask = 0; mask < (1 << n); ++mask) {
         vector<uint32_t> deg(n, 0);
         int sz = 0;
@@ -30,31 +43,37 @@ Polynomial<Rational> get_sigma(int n, int k) {
     return result;
 }
 
-void root_n(int n) {
+template <class Compare, template <class, class> class Terms = MapTerms>
+void root_n(int n, const string& order, SelectionStrategy strategy = SelectionStrategy::Normal, GroebnerEngine engine = GroebnerEngine::Buchberger, size_t threads_count = 1) {
     double start_time = TIME;
-    cout << "root_n test for n = " << n << endl;
-    Ideal<Rational> ideal;
+    cout << "root_n test for n = " << n << " (" << order << ")" << endl;
+    Ideal<Rational, Compare, Terms> ideal;
     for (int k = 1; k < n; ++k) {
-        ideal.add(get_sigma(n, k));
+        ideal.add(get_sigma<Compare, Terms>(n, k));
     }
-    Polynomial<Rational> s_n = get_sigma(n, n);
+    Polynomial<Rational, Compare, Terms> s_n = get_sigma<Compare, Terms>(n, n);
     int coef = (n % 2 == 1 ? -1 : 1);
     s_n.add({}, coef);
     ideal.add(s_n);
-    ideal.make_minimal_groebner_basis();
+    ideal.set_selection_strategy(strategy);
+    ideal.set_threads_count(threads_count);
+    ideal.make_minimal_groebner_basis(engine);
     cout << "working time: " << TIME - start_time << endl;
+    cout << ideal.get_stats() << endl;
 }
 
-void test_root_n(int n) {
+template <class Compare, template <class, class> class Terms = MapTerms>
+void test_root_n(int n, const string& order, SelectionStrategy strategy = SelectionStrategy::Normal, GroebnerEngine engine = GroebnerEngine::Buchberger, size_t threads_count = 1) {
     for (int i = 1; i <= n; ++i) {
-        root_n(i);
+        root_n<Compare, Terms>(i, order, strategy, engine, threads_count);
     }
 }
 
 constexpr int MOD = 239;
 
-Polynomial<Modular<MOD>> get_cyclic(int n, int k) {
-    Polynomial<Modular<MOD>> result;
+template <class Compare, template <class, class> class Terms = MapTerms, class Field = Modular<MOD>>
+Polynomial<Field, Compare, Terms> get_cyclic(int n, int k) {
+    Polynomial<Field, Compare, Terms> result;
     for (int i = 0; i < n; ++i) {
         vector<uint32_t> deg(n, 0);
         for (int j = 0; j < k; ++j) {
@@ -65,27 +84,364 @@ Polynomial<Modular<MOD>> get_cyclic(int n, int k) {
     return result;
 }
 
-void cyclic_n(int n) {
+// Katsura system in the variables u_0, ..., u_n, u_{-l} = u_l and u_l = 0 for l > n.
+template <class Compare>
+Ideal<Rational, Compare> get_katsura_n(int n) {
+    auto get_variable = [n] (int l) {
+        vector<uint32_t> degree(n + 1, 0);
+        degree[abs(l)] = 1;
+        return degree;
+    };
+    Ideal<Rational, Compare> ideal;
+    Polynomial<Rational, Compare> sum;
+    for (int l = -n; l <= n; ++l) {
+        sum.add(Monomial(get_variable(l)), 1);
+    }
+    sum.subtract({}, 1);
+    ideal.add(sum);
+    for (int m = 0; m < n; ++m) {
+        Polynomial<Rational, Compare> polynomial;
+        for (int l = -n; l <= n; ++l) {
+            if (abs(m - l) > n) {
+                continue;
+            }
+            auto degree = get_variable(l);
+            degree[abs(m - l)] += 1;
+            polynomial.add(Monomial(std::move(degree)), 1);
+        }
+        polynomial.subtract(Monomial(get_variable(m)), 1);
+        ideal.add(polynomial);
+    }
+    return ideal;
+}
+
+// The coefficients of the computation, the result is the basis over the rationals.
+enum class Coefficients {
+    Rational,
+    FractionFree,
+    Modular
+};
+
+// The time is the wall time, the multi-modular algorithm runs the primes in parallel.
+template <class Compare, class ModularField = DynamicModular>
+void katsura_n(int n, const string& order, Coefficients coefficients, GroebnerEngine engine = GroebnerEngine::Buchberger, size_t threads_count = 1) {
+    auto start_time = chrono::steady_clock::now();
+    cout << "katsura_n test for n = " << n << " (" << order << ")" << endl;
+    auto ideal = get_katsura_n<Compare>(n);
+    if (coefficients == Coefficients::Modular) {
+        ModularBasis<Compare, MapTerms, ModularField> basis(ideal.get_basis());
+        if (basis.compute(threads_count, engine)) {
+            cout << "primes: " << basis.get_primes_count() << endl;
+        } else {
+            cout << "primes are exhausted" << endl;
+        }
+    } else if (coefficients == Coefficients::FractionFree) {
+        make_fraction_free_groebner_basis(ideal, threads_count);
+    } else {
+        ideal.make_minimal_groebner_basis(engine);
+    }
+    cout << "working time: " << chrono::duration<double>(chrono::steady_clock::now() - start_time).count() << endl;
+}
+
+template <class Compare, class ModularField = DynamicModular>
+void test_katsura_n(int n, const string& order, Coefficients coefficients, GroebnerEngine engine = GroebnerEngine::Buchberger, size_t threads_count = 1) {
+    for (int i = 1; i <= n; ++i) {
+        katsura_n<Compare, ModularField>(i, order, coefficients, engine, threads_count);
+    }
+}
+
+template <class Compare, template <class, class> class Terms = MapTerms, class Field = Modular<MOD>>
+void cyclic_n(int n, const string& order, SelectionStrategy strategy = SelectionStrategy::Normal, GroebnerEngine engine = GroebnerEngine::Buchberger, size_t threads_count = 1) {
     double start_time = TIME;
-    cout << "cyclic_n test for n = " << n << endl;
-    Ideal<Modular<MOD>> ideal;
+    cout << "cyclic_n test for n = " << n << " (" << order << ")" << endl;
+    Ideal<Field, Compare, Terms> ideal;
     for (int k = 1; k < n; ++k) {
-        ideal.add(get_cyclic(n, k));
+        ideal.add(get_cyclic<Compare, Terms, Field>(n, k));
     }
-    Polynomial<Modular<MOD>> s_n = get_cyclic(n, n);
+    Polynomial<Field, Compare, Terms> s_n = get_cyclic<Compare, Terms, Field>(n, n);
     s_n.subtract({}, 1);
     ideal.add(s_n);
-    ideal.make_groebner_basis();
+    ideal.set_selection_strategy(strategy);
+    ideal.set_threads_count(threads_count);
+    ideal.make_groebner_basis(engine);
     cout << "working time: " << TIME - start_time << endl;
+    cout << ideal.get_stats() << endl;
 }
 
-void test_cyclic_n(int n) {
+template <class Compare, template <class, class> class Terms = MapTerms, class Field = Modular<MOD>>
+void test_cyclic_n(int n, const string& order, SelectionStrategy strategy = SelectionStrategy::Normal, GroebnerEngine engine = GroebnerEngine::Buchberger, size_t threads_count = 1) {
     for (int i = 1; i <= n; ++i) {
-        cyclic_n(i);
+        cyclic_n<Compare, Terms, Field>(i, order, strategy, engine, threads_count);
+    }
+}
+
+constexpr ModularValueType FIELD_MOD = 2147483647u;
+
+// Multiply-add chains and divisions of pseudo-random residues modulo FIELD_MOD.
+template <class Field>
+void field_operations(const string& field) {
+    auto start_time = chrono::steady_clock::now();
+    mt19937 generator(0);
+    vector<Field> values(1 << 10);
+    for (auto& value : values) {
+        value = Field(1 + generator() % (FIELD_MOD - 1));
+    }
+    Field sum;
+    for (int round = 0; round < 10000; ++round) {
+        for (size_t i = 1; i < values.size(); ++i) {
+            sum += values[i - 1] * values[i];
+            sum -= values[i];
+        }
+    }
+    Field quotient = Field(1);
+    for (int round = 0; round < 1000; ++round) {
+        for (const auto& value : values) {
+            quotient /= value;
+        }
+    }
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start_time;
+    cout << "field operations (" << field << "), working time: " << elapsed.count() << ", checksum: " << (sum * quotient).get_value() << endl;
+}
+
+// Rows of 2^16 residues (256 KB) fit into the cache, the sums of the sparse rows (8 MB) don't.
+void row_kernels(RowKernels kernels) {
+    const size_t size = 1 << 16;
+    const int rounds = 2000;
+    mt19937 generator(0);
+    vector<uint32_t> row(size);
+    vector<uint32_t> pivot(size);
+    for (size_t i = 0; i < size; ++i) {
+        row[i] = generator() % FIELD_MOD;
+        pivot[i] = generator() % FIELD_MOD;
+    }
+    auto start_time = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        subtract_scaled_row(row.data(), pivot.data(), size, 1 + generator() % (FIELD_MOD - 1), FIELD_MOD, kernels);
+    }
+    chrono::duration<double> subtraction = chrono::steady_clock::now() - start_time;
+    start_time = chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        scale_row(row.data(), size, 1 + generator() % (FIELD_MOD - 1), FIELD_MOD, kernels);
+    }
+    chrono::duration<double> scaling = chrono::steady_clock::now() - start_time;
+    vector<uint64_t> sums(size * 16, 0);
+    vector<uint32_t> columns;
+    for (size_t i = 0; i < sums.size(); i += 1 + generator() % 8) {
+        columns.push_back(static_cast<uint32_t>(i));
+    }
+    vector<uint32_t> values(columns.size());
+    for (auto& value : values) {
+        value = generator() % FIELD_MOD;
+    }
+    const uint64_t reduction = (uint64_t(1) << 63u) / FIELD_MOD * FIELD_MOD;
+    start_time = chrono::steady_clock::now();
+    for (int round = 0; round < rounds / 16; ++round) {
+        add_scaled_sparse_row(sums.data(), columns.data(), values.data(), columns.size(), generator() % FIELD_MOD, reduction, kernels);
+    }
+    chrono::duration<double> sparse = chrono::steady_clock::now() - start_time;
+    const double dense_bytes = 1e-9 * rounds * size * sizeof(uint32_t);
+    const double sparse_bytes = 1e-9 * (rounds / 16) * columns.size() * (2 * sizeof(uint32_t) + 2 * sizeof(uint64_t));
+    uint64_t checksum = 0;
+    for (size_t i = 0; i < size; ++i) {
+        checksum += row[i] + sums[i * 16];
+    }
+    cout << "row kernels (" << kernels << "), scaled subtraction: " << 3 * dense_bytes / subtraction.count() << " GB/s"
+         << ", scaling: " << 2 * dense_bytes / scaling.count() << " GB/s"
+         << ", sparse: " << sparse_bytes / sparse.count() << " GB/s, checksum: " << checksum << endl;
+}
+
+template <template <class, class> class Terms>
+Polynomial<Modular<MOD>, GrevlexOrder, Terms> get_dense(int n, int degree) {
+    Polynomial<Modular<MOD>, GrevlexOrder, Terms> result;
+    vector<uint32_t> deg(n, 0);
+    int value = 1;
+    while (true) {
+        result.add(Monomial(vector<uint32_t>(deg)), value);
+        value = value % (MOD - 1) + 1;
+        int i = 0;
+        while (i < n && deg[i] == static_cast<uint32_t>(degree)) {
+            deg[i++] = 0;
+        }
+        if (i == n) {
+            break;
+        }
+        deg[i]++;
     }
+    return result;
+}
+
+template <template <class, class> class Terms>
+Polynomial<Modular<MOD>, GrevlexOrder, Terms> get_sparse(int n, int terms, int degree, unsigned seed) {
+    Polynomial<Modular<MOD>, GrevlexOrder, Terms> result;
+    mt19937 generator(seed);
+    for (int i = 0; i < terms; ++i) {
+        vector<uint32_t> deg(n);
+        for (auto& value : deg) {
+            value = generator() % degree;
+        }
+        result.add(Monomial(std::move(deg)), 1 + generator() % (MOD - 1));
+    }
+    return result;
+}
+
+template <template <class, class> class Terms>
+void multiplication(const Polynomial<Modular<MOD>, GrevlexOrder, Terms>& f,
+                    const Polynomial<Modular<MOD>, GrevlexOrder, Terms>& g,
+                    const string& name) {
+    cout << "multiplication test for " << f.get_terms_count() << " x " << g.get_terms_count() << " terms (" << name << ")" << endl;
+    double start_time = TIME;
+    auto serial = Polynomial<Modular<MOD>, GrevlexOrder, Terms>::multiply(f, g, 1);
+    cout << "serial working time: " << TIME - start_time << endl;
+    auto start = chrono::steady_clock::now();
+    auto parallel = f * g;
+    chrono::duration<double> elapsed = chrono::steady_clock::now() - start;
+    cout << "operator* wall time: " << elapsed.count() << (serial == parallel ? "" : " (mismatch)") << endl;
+}
+
+template <template <class, class> class Terms>
+void test_multiplication(const string& storage) {
+    auto f = get_dense<Terms>(4, 6);
+    multiplication<Terms>(f, f * Monomial({1}) + f, "dense, " + storage);
+    multiplication<Terms>(get_sparse<Terms>(4, 2000, 50, 1), get_sparse<Terms>(4, 2000, 50, 2), "sparse, " + storage);
+}
+
+// Random quadratic equations in n variables, every monomial has the probability 1/2.
+vector<vector<vector<uint32_t>>> get_quadratic_system(int n, unsigned seed) {
+    vector<vector<vector<uint32_t>>> result(n);
+    mt19937 generator(seed);
+    for (auto& equation : result) {
+        for (int i = -1; i < n; ++i) {
+            for (int j = max(i, 0); j < n; ++j) {
+                if (generator() % 2 == 0) {
+                    continue;
+                }
+                vector<uint32_t> deg(n, 0);
+                if (i >= 0) {
+                    deg[i] = 1;
+                }
+                deg[j] = 1;
+                equation.push_back(i < 0 && j == 0 ? vector<uint32_t>() : deg);
+            }
+        }
+    }
+    return result;
+}
+
+// The modular computation adds the field equations x_i^2 - x_i explicitly.
+template <class Field, template <class, class> class Terms = MapTerms>
+void boolean_n(int n, const string& name) {
+    using MonomialType = typename FieldMonomial<Field>::Type;
+    double start_time = TIME;
+    cout << "boolean test for n = " << n << " (" << name << ")" << endl;
+    Ideal<Field, GrevlexOrder, Terms> ideal;
+    for (auto& equation : get_quadratic_system(n, n)) {
+        Polynomial<Field, GrevlexOrder, Terms> polynomial;
+        for (auto& deg : equation) {
+            polynomial.add(MonomialType(std::move(deg)), 1);
+        }
+        ideal.add(polynomial);
+    }
+    if (!MonomialType::IS_MULTILINEAR) {
+        for (int i = 0; i < n; ++i) {
+            Polynomial<Field, GrevlexOrder, Terms> equation;
+            vector<uint32_t> deg(n, 0);
+            deg[i] = 1;
+            equation.subtract(MonomialType(vector<uint32_t>(deg)), 1);
+            deg[i] = 2;
+            equation.add(MonomialType(std::move(deg)), 1);
+            ideal.add(equation);
+        }
+    }
+    ideal.make_minimal_groebner_basis();
+    cout << "working time: " << TIME - start_time << endl;
+    cout << ideal.get_stats() << endl;
+}
+
+template <class Field, template <class, class> class Terms = MapTerms>
+void test_boolean_n(int from, int to, const string& name) {
+    for (int i = from; i <= to; ++i) {
+        boolean_n<Field, Terms>(i, name);
+    }
+}
+
+// Writes a random system of about megabytes * 10^6 bytes and loads it from the mapped file and from a stream.
+template <class Field>
+void loader(int megabytes, const string& field, size_t threads_count) {
+    const string path = "benchmark_input.txt";
+    {
+        mt19937 generator(0);
+        ofstream out(path);
+        for (size_t size = 0; size < megabytes * 1000000ull;) {
+            string polynomial;
+            for (int i = 0; i < 100; ++i) {
+                polynomial += (i == 0 ? "" : generator() % 2 == 0 ? "+" : "-") + to_string(generator() % 1000000) + "/" + to_string(1 + generator() % 200);
+                for (int j = 0; j < 8; ++j) {
+                    if (generator() % 2 == 0) {
+                        polynomial += "*x_" + to_string(j) + "^" + to_string(1 + generator() % 5);
+                    }
+                }
+            }
+            out << polynomial << "\n";
+            size += polynomial.size() + 1;
+        }
+    }
+    cout << "loader test for " << megabytes << " MB (" << field << ", " << threads_count << " threads)" << endl;
+    parser::IdealLoader<Field, GrevlexOrder> file_loader(threads_count);
+    file_loader.load_file(path);
+    cout << "mapped file: " << file_loader.get_stats() << endl;
+    ifstream in(path);
+    parser::IdealLoader<Field, GrevlexOrder> stream_loader(threads_count);
+    stream_loader.load_stream(in);
+    cout << "stream: " << stream_loader.get_stats() << endl;
+    remove(path.c_str());
 }
 
 int main() {
-    test_root_n(10);
-    test_cyclic_n(6);
+    test_root_n<LexOrder>(10, "lex");
+    test_root_n<DeglexOrder>(10, "deglex");
+    test_root_n<GrevlexOrder>(10, "grevlex");
+    test_root_n<LexOrder, VectorTerms>(10, "lex, vector terms");
+    test_root_n<LexOrder>(10, "lex, sugar", SelectionStrategy::Sugar);
+    test_root_n<LexOrder>(10, "lex, F4", SelectionStrategy::Normal, GroebnerEngine::F4);
+    test_root_n<GrevlexOrder>(10, "grevlex, F4", SelectionStrategy::Normal, GroebnerEngine::F4);
+    test_root_n<GrevlexOrder>(10, "grevlex, signature", SelectionStrategy::Normal, GroebnerEngine::Signature);
+    test_cyclic_n<LexOrder>(6, "lex");
+    test_cyclic_n<DeglexOrder>(6, "deglex");
+    test_cyclic_n<GrevlexOrder>(6, "grevlex");
+    test_cyclic_n<LexOrder, VectorTerms>(6, "lex, vector terms");
+    test_cyclic_n<LexOrder>(6, "lex, sugar", SelectionStrategy::Sugar);
+    test_cyclic_n<LexOrder>(6, "lex, F4", SelectionStrategy::Normal, GroebnerEngine::F4);
+    test_cyclic_n<GrevlexOrder>(6, "grevlex, F4", SelectionStrategy::Normal, GroebnerEngine::F4);
+    test_cyclic_n<GrevlexOrder>(6, "grevlex, signature", SelectionStrategy::Normal, GroebnerEngine::Signature);
+    test_cyclic_n<GrevlexOrder>(6, "grevlex, 4 threads", SelectionStrategy::Normal, GroebnerEngine::Buchberger, 4);
+    {
+        ModularContext context(MOD);
+        DynamicModular::ContextGuard guard(context);
+        test_cyclic_n<GrevlexOrder, MapTerms, DynamicModular>(6, "grevlex, runtime modulo");
+        test_cyclic_n<LexOrder, MapTerms, DynamicModular>(6, "lex, F4, runtime modulo", SelectionStrategy::Normal, GroebnerEngine::F4);
+    }
+    field_operations<Modular<FIELD_MOD>>("compile-time modulo");
+    {
+        ModularContext context(FIELD_MOD);
+        DynamicModular::ContextGuard guard(context);
+        field_operations<DynamicModular>("runtime modulo");
+    }
+    row_kernels(RowKernels::Scalar);
+    if (get_row_kernels() != RowKernels::Scalar) {
+        row_kernels(get_row_kernels());
+    }
+    test_katsura_n<GrevlexOrder>(6, "grevlex", Coefficients::Rational);
+    test_katsura_n<GrevlexOrder>(6, "grevlex, fraction-free", Coefficients::FractionFree);
+    test_katsura_n<GrevlexOrder>(6, "grevlex, modular, F4", Coefficients::Modular, GroebnerEngine::F4);
+    test_katsura_n<GrevlexOrder>(6, "grevlex, modular, F4, 4 threads", Coefficients::Modular, GroebnerEngine::F4, 4);
+    test_katsura_n<GrevlexOrder, DynamicModular64>(6, "grevlex, modular 64-bit, F4", Coefficients::Modular, GroebnerEngine::F4);
+    test_multiplication<MapTerms>("map terms");
+    test_multiplication<VectorTerms>("vector terms");
+    test_boolean_n<Boolean, BooleanTerms>(4, 12, "boolean terms");
+    test_boolean_n<Boolean>(4, 12, "boolean, map terms");
+    test_boolean_n<Modular<2>>(4, 12, "modulo 2, field equations");
+    loader<Rational>(50, "rational", 1);
+    loader<Rational>(50, "rational", 4);
+    loader<Modular<MOD>>(50, "modulo " + to_string(MOD), 1);
+    loader<Modular<MOD>>(50, "modulo " + to_string(MOD), 4);
 }
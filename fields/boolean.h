@@ -0,0 +1,95 @@
+#ifndef GROEBNER_BASIS_BOOLEAN_H
+#define GROEBNER_BASIS_BOOLEAN_H
+
+#include <cassert>
+#include <iostream>
+#include <type_traits>
+
+namespace math {
+
+    /*
+     * Field of two elements of the boolean polynomials: the sum is xor and the product is and.
+     * The polynomials over it have BooleanMonomial monomials, which satisfy the field equations
+     * x_i^2 = x_i, and BooleanTerms keeps only the monomials of the terms.
+     */
+    class Boolean {
+    public:
+        Boolean() = default;
+
+        template <typename T>
+        Boolean(T value) : value_(value % 2 != 0) {
+            static_assert(std::is_integral_v<T>, "the value should be an integer");
+        }
+
+        friend bool operator==(const Boolean& first, const Boolean& second) {
+            return first.value_ == second.value_;
+        }
+
+        friend bool operator!=(const Boolean& first, const Boolean& second) {
+            return !(first == second);
+        }
+
+        friend Boolean operator+(const Boolean& first, const Boolean& second) {
+            Boolean result = first;
+            result += second;
+            return result;
+        }
+
+        Boolean operator+=(const Boolean& other) {
+            value_ = value_ != other.value_;
+            return *this;
+        }
+
+        friend Boolean operator-(const Boolean& first, const Boolean& second) {
+            return first + second;
+        }
+
+        Boolean operator-=(const Boolean& other) {
+            return *this += other;
+        }
+
+        friend Boolean operator*(const Boolean& first, const Boolean& second) {
+            Boolean result = first;
+            result *= second;
+            return result;
+        }
+
+        Boolean operator*=(const Boolean& other) {
+            value_ = value_ && other.value_;
+            return *this;
+        }
+
+        friend Boolean operator/(const Boolean& first, const Boolean& second) {
+            Boolean result = first;
+            result /= second;
+            return result;
+        }
+
+        Boolean operator/=(const Boolean& other) {
+            assert(((void)"division by zero", !other.is_zero()));
+            return *this;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const Boolean& element) {
+            out << element.value_;
+            return out;
+        }
+
+        bool is_zero() const {
+            return !value_;
+        }
+
+        bool is_one() const {
+            return value_;
+        }
+
+        bool get_value() const {
+            return value_;
+        }
+
+    private:
+        bool value_ = false;
+    };
+}
+
+#endif
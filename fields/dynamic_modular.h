@@ -0,0 +1,257 @@
+#ifndef GROEBNER_BASIS_DYNAMIC_MODULAR_H
+#define GROEBNER_BASIS_DYNAMIC_MODULAR_H
+
+#include "modular.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+namespace math {
+
+    bool is_prime(ModularValueType value) {
+        if (value < 2) {
+            return false;
+        }
+        for (ModularValueType divisor = 2; static_cast<ModularValueType64>(divisor) * divisor <= value; ++divisor) {
+            if (value % divisor == 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The greatest prime less than the value, or 0 if there is no such prime.
+    ModularValueType get_previous_prime(ModularValueType value) {
+        while (value > 2) {
+            --value;
+            if (is_prime(value)) {
+                return value;
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * Prime modulo of DynamicModular chosen at runtime. A product x < 2^64 is reduced by the
+     * Barrett constant m = floor(2^64 / modulo): floor(x * m / 2^64) is less than floor(x / modulo)
+     * by at most one, so the remainder needs at most one subtraction. The sums of products are
+     * kept less than 2^63 by subtracting the greatest multiple of the modulo not exceeding 2^63.
+     */
+    class ModularContext {
+    public:
+        static constexpr ModularValueType64 ACCUMULATOR_LIMIT = ModularValueType64(1) << 63u;
+
+        explicit ModularContext(ModularValueType modulo) :
+            modulo_(modulo),
+            barrett_(static_cast<ModularValueType64>((static_cast<unsigned __int128>(1) << 64u) / modulo)),
+            reduction_(ACCUMULATOR_LIMIT / modulo * modulo)
+        {
+            assert(((void)"modulo should be at least 2 and less than 2^31", modulo >= 2 && modulo < (1u << 31u)));
+        }
+
+        ModularValueType get_modulo() const {
+            return modulo_;
+        }
+
+        ModularValueType reduce(ModularValueType64 value) const {
+            const auto quotient = static_cast<ModularValueType64>((static_cast<unsigned __int128>(value) * barrett_) >> 64u);
+            const ModularValueType64 result = value - quotient * modulo_;
+            return static_cast<ModularValueType>(result >= modulo_ ? result - modulo_ : result);
+        }
+
+        ModularValueType64 get_reduction() const {
+            return reduction_;
+        }
+
+    private:
+        ModularValueType modulo_;
+        ModularValueType64 barrett_;
+        ModularValueType64 reduction_;
+    };
+
+    class DynamicModularAccumulator;
+
+    /*
+     * Residues modulo a prime given at runtime. The modulo is the context of the thread set by
+     * ContextGuard, all the elements used by a thread belong to its context. Sums are reduced by
+     * a comparison, products by the Barrett reduction of the context and the inverse is found by
+     * the extended Euclidean algorithm.
+     */
+    class DynamicModular {
+    public:
+        using ContextType = const ModularContext*;
+        using AccumulatorType = DynamicModularAccumulator;
+
+        // Sets the context of the current thread until the end of the scope.
+        class ContextGuard {
+        public:
+            explicit ContextGuard(const ModularContext& context) : previous_(context_) {
+                context_ = &context;
+            }
+
+            ContextGuard(const ContextGuard&) = delete;
+
+            ContextGuard& operator=(const ContextGuard&) = delete;
+
+            ~ContextGuard() {
+                context_ = previous_;
+            }
+
+        private:
+            ContextType previous_;
+        };
+
+        DynamicModular() = default;
+
+        DynamicModular(ModularValueType value) : value_(value) {
+            assert(((void)"value should be less than modulo", value < get_modulo()));
+        }
+
+        static ContextType get_context() {
+            return context_;
+        }
+
+        static void set_context(ContextType context) {
+            context_ = context;
+        }
+
+        static ModularValueType get_modulo() {
+            assert(((void)"the context of the thread should be set", context_ != nullptr));
+            return context_->get_modulo();
+        }
+
+        friend bool operator==(const DynamicModular& first, const DynamicModular& second) {
+            return first.value_ == second.value_;
+        }
+
+        friend bool operator!=(const DynamicModular& first, const DynamicModular& second) {
+            return !(first == second);
+        }
+
+        friend DynamicModular operator+(const DynamicModular& first, const DynamicModular& second) {
+            DynamicModular result = first;
+            result += second;
+            return result;
+        }
+
+        DynamicModular operator+=(const DynamicModular& other) {
+            const ModularValueType modulo = get_modulo();
+            value_ += other.value_;
+            if (value_ >= modulo) {
+                value_ -= modulo;
+            }
+            return *this;
+        }
+
+        friend DynamicModular operator-(const DynamicModular& first, const DynamicModular& second) {
+            DynamicModular result = first;
+            result -= second;
+            return result;
+        }
+
+        DynamicModular operator-=(const DynamicModular& other) {
+            if (value_ >= other.value_) {
+                value_ -= other.value_;
+            } else {
+                value_ += get_modulo() - other.value_;
+            }
+            return *this;
+        }
+
+        friend DynamicModular operator*(const DynamicModular& first, const DynamicModular& second) {
+            DynamicModular result = first;
+            result *= second;
+            return result;
+        }
+
+        DynamicModular operator*=(const DynamicModular& other) {
+            value_ = context_->reduce(static_cast<ModularValueType64>(value_) * other.value_);
+            return *this;
+        }
+
+        friend DynamicModular operator/(const DynamicModular& first, const DynamicModular& second) {
+            return first * second.inverse();
+        }
+
+        DynamicModular operator/=(const DynamicModular& other) {
+            *this *= other.inverse();
+            return *this;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const DynamicModular& element) {
+            out << "[" << element.value_ << " (modulo " << get_modulo() << ")]";
+            return out;
+        }
+
+        bool is_zero() const {
+            return value_ == 0;
+        }
+
+        bool is_one() const {
+            return value_ == 1;
+        }
+
+        ModularValueType get_value() const {
+            return value_;
+        }
+
+    private:
+        DynamicModular inverse() const {
+            assert(((void)"division by zero", value_ != 0));
+            int64_t previous_remainder = get_modulo();
+            int64_t remainder = value_;
+            int64_t previous_coefficient = 0;
+            int64_t coefficient = 1;
+            while (remainder != 0) {
+                const int64_t quotient = previous_remainder / remainder;
+                previous_remainder -= quotient * remainder;
+                std::swap(previous_remainder, remainder);
+                previous_coefficient -= quotient * coefficient;
+                std::swap(previous_coefficient, coefficient);
+            }
+            if (previous_coefficient < 0) {
+                previous_coefficient += get_modulo();
+            }
+            return static_cast<ModularValueType>(previous_coefficient);
+        }
+
+        inline static thread_local ContextType context_ = nullptr;
+
+        ModularValueType value_ = 0;
+    };
+
+    // Sum of products with delayed reduction like ModularAccumulator, in the context of the thread.
+    class DynamicModularAccumulator {
+    public:
+        DynamicModularAccumulator() = default;
+
+        DynamicModularAccumulator(const DynamicModular& value) : value_(value.get_value()) {}
+
+        void add_product(const DynamicModular& first, const DynamicModular& second) {
+            value_ += static_cast<ModularValueType64>(first.get_value()) * second.get_value();
+            if (value_ >= ModularContext::ACCUMULATOR_LIMIT) {
+                value_ -= DynamicModular::get_context()->get_reduction();
+            }
+        }
+
+        DynamicModular get() const {
+            return DynamicModular::get_context()->reduce(value_);
+        }
+
+        static void add_scaled_row(DynamicModularAccumulator* sums, const uint32_t* columns, const DynamicModular* values, size_t size, const DynamicModular& factor) {
+            static_assert(sizeof(DynamicModularAccumulator) == sizeof(ModularValueType64) && sizeof(DynamicModular) == sizeof(ModularValueType));
+            add_scaled_sparse_row(reinterpret_cast<ModularValueType64*>(sums), columns, reinterpret_cast<const ModularValueType*>(values), size, factor.get_value(), DynamicModular::get_context()->get_reduction());
+        }
+
+        static void scale_row(DynamicModular* values, size_t size, const DynamicModular& factor) {
+            math::scale_row(reinterpret_cast<ModularValueType*>(values), size, factor.get_value(), DynamicModular::get_modulo());
+        }
+
+    private:
+        ModularValueType64 value_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,273 @@
+#ifndef GROEBNER_BASIS_DYNAMIC_MODULAR64_H
+#define GROEBNER_BASIS_DYNAMIC_MODULAR64_H
+
+#include "modular.h"
+
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <utility>
+
+namespace math {
+
+    using ModularValueType128 = unsigned __int128;
+
+    ModularValueType64 multiply_modulo(ModularValueType64 first, ModularValueType64 second, ModularValueType64 modulo) {
+        return static_cast<ModularValueType64>(static_cast<ModularValueType128>(first) * second % modulo);
+    }
+
+    // Miller-Rabin test, the first 12 primes as the bases are enough for all the 64-bit numbers.
+    bool is_prime64(ModularValueType64 value) {
+        if (value < 2) {
+            return false;
+        }
+        constexpr ModularValueType64 BASES[] = {2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37};
+        for (ModularValueType64 base : BASES) {
+            if (value % base == 0) {
+                return value == base;
+            }
+        }
+        ModularValueType64 odd = value - 1;
+        size_t twos = 0;
+        while (odd % 2 == 0) {
+            odd /= 2;
+            ++twos;
+        }
+        for (ModularValueType64 base : BASES) {
+            ModularValueType64 power = 1;
+            for (ModularValueType64 degree = odd, current = base; degree > 0; degree >>= 1u) {
+                if (degree & 1u) {
+                    power = multiply_modulo(power, current, value);
+                }
+                current = multiply_modulo(current, current, value);
+            }
+            if (power == 1 || power == value - 1) {
+                continue;
+            }
+            size_t i = 1;
+            for (; i < twos; ++i) {
+                power = multiply_modulo(power, power, value);
+                if (power == value - 1) {
+                    break;
+                }
+            }
+            if (i == twos) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // The greatest prime less than the value, or 0 if there is no such prime.
+    ModularValueType64 get_previous_prime64(ModularValueType64 value) {
+        while (value > 2) {
+            --value;
+            if (is_prime64(value)) {
+                return value;
+            }
+        }
+        return 0;
+    }
+
+    /*
+     * Odd prime modulo of DynamicModular64 chosen at runtime. The elements are kept in the
+     * Montgomery form x * 2^64 mod modulo, the product of two such numbers x * y < modulo * 2^64 is
+     * reduced by REDC: with m = x * y * (-modulo^(-1)) mod 2^64 the sum x * y + m * modulo is divisible
+     * by 2^64 and the quotient is less than 2 * modulo. The modulo is less than 2^63, so the sum fits
+     * into 128 bits.
+     */
+    class ModularContext64 {
+    public:
+        explicit ModularContext64(ModularValueType64 modulo) : modulo_(modulo) {
+            assert(((void)"modulo should be odd and less than 2^63", modulo % 2 == 1 && modulo < (ModularValueType64(1) << 63u)));
+            ModularValueType64 inverse = modulo;
+            // Every step of the Newton's method doubles the number of the correct low bits.
+            for (size_t i = 0; i < 5; ++i) {
+                inverse *= 2 - modulo * inverse;
+            }
+            negated_inverse_ = -inverse;
+            one_ = (0 - modulo) % modulo;
+            square_ = multiply_modulo(one_, one_, modulo);
+        }
+
+        ModularValueType64 get_modulo() const {
+            return modulo_;
+        }
+
+        // x * 2^(-64) mod modulo for x < modulo * 2^64.
+        ModularValueType64 reduce(ModularValueType128 value) const {
+            const ModularValueType64 factor = static_cast<ModularValueType64>(value) * negated_inverse_;
+            const auto result = static_cast<ModularValueType64>((value + static_cast<ModularValueType128>(factor) * modulo_) >> 64u);
+            return result >= modulo_ ? result - modulo_ : result;
+        }
+
+        ModularValueType64 to_montgomery(ModularValueType64 value) const {
+            return reduce(static_cast<ModularValueType128>(value) * square_);
+        }
+
+        ModularValueType64 from_montgomery(ModularValueType64 value) const {
+            return reduce(value);
+        }
+
+        // The Montgomery form of 1.
+        ModularValueType64 get_one() const {
+            return one_;
+        }
+
+    private:
+        ModularValueType64 modulo_;
+        ModularValueType64 negated_inverse_;
+        ModularValueType64 one_;
+        ModularValueType64 square_;
+    };
+
+    /*
+     * Residues modulo a 64-bit prime given at runtime, the modulo is the context of the thread set by
+     * ContextGuard like for DynamicModular. The products are found by the Montgomery multiplication
+     * in 128-bit integers, the inverse is found by the extended Euclidean algorithm.
+     */
+    class DynamicModular64 {
+    public:
+        using ContextType = const ModularContext64*;
+
+        // Sets the context of the current thread until the end of the scope.
+        class ContextGuard {
+        public:
+            explicit ContextGuard(const ModularContext64& context) : previous_(context_) {
+                context_ = &context;
+            }
+
+            ContextGuard(const ContextGuard&) = delete;
+
+            ContextGuard& operator=(const ContextGuard&) = delete;
+
+            ~ContextGuard() {
+                context_ = previous_;
+            }
+
+        private:
+            ContextType previous_;
+        };
+
+        DynamicModular64() = default;
+
+        DynamicModular64(ModularValueType64 value) {
+            assert(((void)"value should be less than modulo", value < get_modulo()));
+            value_ = context_->to_montgomery(value);
+        }
+
+        static ContextType get_context() {
+            return context_;
+        }
+
+        static void set_context(ContextType context) {
+            context_ = context;
+        }
+
+        static ModularValueType64 get_modulo() {
+            assert(((void)"the context of the thread should be set", context_ != nullptr));
+            return context_->get_modulo();
+        }
+
+        friend bool operator==(const DynamicModular64& first, const DynamicModular64& second) {
+            return first.value_ == second.value_;
+        }
+
+        friend bool operator!=(const DynamicModular64& first, const DynamicModular64& second) {
+            return !(first == second);
+        }
+
+        friend DynamicModular64 operator+(const DynamicModular64& first, const DynamicModular64& second) {
+            DynamicModular64 result = first;
+            result += second;
+            return result;
+        }
+
+        DynamicModular64 operator+=(const DynamicModular64& other) {
+            const ModularValueType64 modulo = get_modulo();
+            value_ += other.value_;
+            if (value_ >= modulo) {
+                value_ -= modulo;
+            }
+            return *this;
+        }
+
+        friend DynamicModular64 operator-(const DynamicModular64& first, const DynamicModular64& second) {
+            DynamicModular64 result = first;
+            result -= second;
+            return result;
+        }
+
+        DynamicModular64 operator-=(const DynamicModular64& other) {
+            if (value_ >= other.value_) {
+                value_ -= other.value_;
+            } else {
+                value_ += get_modulo() - other.value_;
+            }
+            return *this;
+        }
+
+        friend DynamicModular64 operator*(const DynamicModular64& first, const DynamicModular64& second) {
+            DynamicModular64 result = first;
+            result *= second;
+            return result;
+        }
+
+        DynamicModular64 operator*=(const DynamicModular64& other) {
+            value_ = context_->reduce(static_cast<ModularValueType128>(value_) * other.value_);
+            return *this;
+        }
+
+        friend DynamicModular64 operator/(const DynamicModular64& first, const DynamicModular64& second) {
+            return first * second.inverse();
+        }
+
+        DynamicModular64 operator/=(const DynamicModular64& other) {
+            *this *= other.inverse();
+            return *this;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const DynamicModular64& element) {
+            out << "[" << element.get_value() << " (modulo " << get_modulo() << ")]";
+            return out;
+        }
+
+        bool is_zero() const {
+            return value_ == 0;
+        }
+
+        bool is_one() const {
+            return value_ == context_->get_one();
+        }
+
+        ModularValueType64 get_value() const {
+            return context_->from_montgomery(value_);
+        }
+
+    private:
+        DynamicModular64 inverse() const {
+            assert(((void)"division by zero", value_ != 0));
+            __int128 previous_remainder = get_modulo();
+            __int128 remainder = get_value();
+            __int128 previous_coefficient = 0;
+            __int128 coefficient = 1;
+            while (remainder != 0) {
+                const __int128 quotient = previous_remainder / remainder;
+                previous_remainder -= quotient * remainder;
+                std::swap(previous_remainder, remainder);
+                previous_coefficient -= quotient * coefficient;
+                std::swap(previous_coefficient, coefficient);
+            }
+            if (previous_coefficient < 0) {
+                previous_coefficient += get_modulo();
+            }
+            return static_cast<ModularValueType64>(previous_coefficient);
+        }
+
+        inline static thread_local ContextType context_ = nullptr;
+
+        ModularValueType64 value_ = 0;
+    };
+}
+
+#endif
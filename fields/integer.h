@@ -0,0 +1,123 @@
+/*
+ * boost library should be installed to use this class
+ */
+
+#ifndef GROEBNER_BASIS_INTEGER_H
+
+#define GROEBNER_BASIS_INTEGER_H
+
+#include <boost/multiprecision/gmp.hpp>
+
+#include <cassert>
+#include <iostream>
+
+namespace math {
+
+    using IntegerType = boost::multiprecision::mpz_int;
+
+    /*
+     * Ring of integers, the coefficients of the fraction-free computations over the rationals.
+     * It is not a field: the division is exact, the dividend should be a multiple of the divisor.
+     * Instead of the inverse the ideals use gcd, see IsField.
+     */
+    class Integer {
+    public:
+        static constexpr bool IS_FIELD = false;
+
+        Integer() = default;
+
+        template <typename T>
+        Integer(T value) : value_(value) {}
+
+        friend bool operator==(const Integer& first, const Integer& second) {
+            return first.value_ == second.value_;
+        }
+
+        friend bool operator!=(const Integer& first, const Integer& second) {
+            return !(first == second);
+        }
+
+        friend Integer operator+(const Integer& first, const Integer& second) {
+            Integer result = first;
+            result += second;
+            return result;
+        }
+
+        Integer operator+=(const Integer& other) {
+            value_ += other.value_;
+            return *this;
+        }
+
+        friend Integer operator-(const Integer& first, const Integer& second) {
+            Integer result = first;
+            result -= second;
+            return result;
+        }
+
+        Integer operator-=(const Integer& other) {
+            value_ -= other.value_;
+            return *this;
+        }
+
+        friend Integer operator*(const Integer& first, const Integer& second) {
+            Integer result = first;
+            result *= second;
+            return result;
+        }
+
+        Integer operator*=(const Integer& other) {
+            value_ *= other.value_;
+            return *this;
+        }
+
+        friend Integer operator/(const Integer& first, const Integer& second) {
+            Integer result = first;
+            result /= second;
+            return result;
+        }
+
+        Integer operator/=(const Integer& other) {
+            assert(((void)"division by zero", !other.is_zero()));
+            assert(((void)"the division should be exact", value_ % other.value_ == 0));
+            mpz_divexact(value_.backend().data(), value_.backend().data(), other.value_.backend().data());
+            return *this;
+        }
+
+        // The greatest common divisor is not negative.
+        friend Integer gcd(const Integer& first, const Integer& second) {
+            Integer result;
+            mpz_gcd(result.value_.backend().data(), first.value_.backend().data(), second.value_.backend().data());
+            return result;
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const Integer& element) {
+            if (element.is_negative()) {
+                out << "(" << element.value_ << ")";
+            } else {
+                out << element.value_;
+            }
+            return out;
+        }
+
+        bool is_zero() const {
+            return value_.is_zero();
+        }
+
+        bool is_one() const {
+            return value_ == 1;
+        }
+
+        bool is_negative() const {
+            return value_.sign() < 0;
+        }
+
+        const IntegerType& get_value() const {
+            return value_;
+        }
+
+    private:
+        IntegerType value_ = 0;
+    };
+}
+
+#endif
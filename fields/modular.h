@@ -1,17 +1,30 @@
 #ifndef GROEBNER_BASIS_MODULAR_H
 #define GROEBNER_BASIS_MODULAR_H
 
+#include "row_kernels.h"
+
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 namespace math {
 
     using ModularValueType = uint32_t;
     using ModularValueType64 = uint64_t;
 
+    // The inverses modulo the primes not greater than this limit are taken from a table.
+    constexpr ModularValueType MODULAR_INVERSE_TABLE_LIMIT = 1u << 16u;
+
+    template <ModularValueType modulo>
+    class ModularAccumulator;
+
     template <ModularValueType modulo>
     class Modular {
     public:
+        using AccumulatorType = ModularAccumulator<modulo>;
+
         Modular() = default;
 
         Modular(ModularValueType value) : value_(value) {
@@ -83,23 +96,112 @@ namespace math {
             return value_ == 1;
         }
 
+        ModularValueType get_value() const {
+            return value_;
+        }
+
     private:
         Modular inverse() const {
             assert(((void)"division by zero", value_ != 0));
-            ModularValueType degree = modulo - 2;
-            Modular result = 1u;
-            Modular current_power = *this;
-            for (ModularValueType current_degree = 1u; current_degree <= degree; current_degree <<= 1u) {
-                if (degree & current_degree) {
-                    result *= current_power;
-                }
-                current_power *= current_power;
+            if constexpr (modulo <= MODULAR_INVERSE_TABLE_LIMIT) {
+                static const std::vector<ModularValueType> inverses = get_inverses();
+                return inverses[value_];
+            } else {
+                return get_inverse(value_);
+            }
+        }
+
+        // Extended Euclidean algorithm, the coefficients are kept modulo the modulo.
+        static ModularValueType get_inverse(ModularValueType value) {
+            int64_t previous_remainder = modulo;
+            int64_t remainder = value;
+            int64_t previous_coefficient = 0;
+            int64_t coefficient = 1;
+            while (remainder != 0) {
+                const int64_t quotient = previous_remainder / remainder;
+                previous_remainder -= quotient * remainder;
+                std::swap(previous_remainder, remainder);
+                previous_coefficient -= quotient * coefficient;
+                std::swap(previous_coefficient, coefficient);
+            }
+            if (previous_coefficient < 0) {
+                previous_coefficient += modulo;
+            }
+            return static_cast<ModularValueType>(previous_coefficient);
+        }
+
+        // inverse(i) = -(modulo / i) * inverse(modulo % i), since modulo = (modulo / i) * i + modulo % i.
+        static std::vector<ModularValueType> get_inverses() {
+            std::vector<ModularValueType> result(modulo, 0);
+            if (modulo > 1) {
+                result[1] = 1;
+            }
+            for (ModularValueType i = 2; i < modulo; ++i) {
+                result[i] = (Modular() - Modular(modulo / i) * Modular(result[modulo % i])).value_;
             }
             return result;
         }
 
         ModularValueType value_ = 0;
     };
+
+    /*
+     * Sum of products modulo the prime with delayed reduction: a product is less than 2^62, it is
+     * added to a 64-bit sum, which is kept less than 2^63 by subtracting a multiple of the modulo,
+     * so the sum is reduced by % only once, when its value is needed. The rows of sums are updated
+     * by the row kernels. The products modulo a prime not less than 2^31 are reduced at once.
+     */
+    template <ModularValueType modulo>
+    class ModularAccumulator {
+    public:
+        ModularAccumulator() = default;
+
+        ModularAccumulator(const Modular<modulo>& value) : value_(value.get_value()) {}
+
+        void add_product(const Modular<modulo>& first, const Modular<modulo>& second) {
+            const ModularValueType64 product = static_cast<ModularValueType64>(first.get_value()) * second.get_value();
+            if constexpr (modulo < ROW_KERNELS_MODULO_LIMIT) {
+                value_ += product;
+                if (value_ >= LIMIT) {
+                    value_ -= REDUCTION;
+                }
+            } else {
+                value_ = (value_ + product % modulo) % modulo;
+            }
+        }
+
+        Modular<modulo> get() const {
+            return static_cast<ModularValueType>(value_ % modulo);
+        }
+
+        // sums[columns[i]] += factor * values[i] for the distinct columns.
+        static void add_scaled_row(ModularAccumulator* sums, const uint32_t* columns, const Modular<modulo>* values, size_t size, const Modular<modulo>& factor) {
+            static_assert(sizeof(ModularAccumulator) == sizeof(ModularValueType64) && sizeof(Modular<modulo>) == sizeof(ModularValueType));
+            if constexpr (modulo < ROW_KERNELS_MODULO_LIMIT) {
+                add_scaled_sparse_row(reinterpret_cast<ModularValueType64*>(sums), columns, reinterpret_cast<const ModularValueType*>(values), size, factor.get_value(), REDUCTION);
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    sums[columns[i]].add_product(factor, values[i]);
+                }
+            }
+        }
+
+        static void scale_row(Modular<modulo>* values, size_t size, const Modular<modulo>& factor) {
+            if constexpr (modulo < ROW_KERNELS_MODULO_LIMIT) {
+                math::scale_row(reinterpret_cast<ModularValueType*>(values), size, factor.get_value(), modulo);
+            } else {
+                for (size_t i = 0; i < size; ++i) {
+                    values[i] *= factor;
+                }
+            }
+        }
+
+    private:
+        static constexpr ModularValueType64 LIMIT = ModularValueType64(1) << 63u;
+        static constexpr ModularValueType64 REDUCTION = LIMIT / modulo * modulo;
+
+        ModularValueType64 value_ = 0;
+    };
 }
 
 #endif
@@ -6,85 +6,255 @@
 
 #define GROEBNER_BASIS_RATIONAL_H
 
+#include "integer.h"
+
 #include <boost/multiprecision/gmp.hpp>
 
 #include <cassert>
+#include <cstdint>
 #include <iostream>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <type_traits>
 
 namespace math {
 
     using RationalType = boost::multiprecision::mpq_rational;
 
+    /*
+     * Rational number. A number with the numerator and the denominator not greater than
+     * SMALL_LIMIT by absolute value is kept inline as a reduced fraction and computed in 64-bit
+     * integers with overflow checks, other numbers are kept in GMP. An operation which overflows
+     * is repeated in GMP and a GMP result which fits is moved inline, so every number has a unique
+     * representation.
+     */
     class Rational {
     public:
         Rational() = default;
 
         template <typename T>
-        Rational(T value) : value_(value) {}
+        Rational(T value) {
+            if constexpr (std::is_integral_v<T>) {
+                if (is_small(value)) {
+                    numerator_ = static_cast<int64_t>(value);
+                    return;
+                }
+            }
+            big_.emplace(value);
+            normalize();
+        }
 
         friend bool operator==(const Rational& first, const Rational& second) {
-            return first.value_ == second.value_;
+            if (first.big_ || second.big_) {
+                return first.big_ && second.big_ && *first.big_ == *second.big_;
+            }
+            return first.numerator_ == second.numerator_ && first.denominator_ == second.denominator_;
         }
 
         friend bool operator!=(const Rational& first, const Rational& second) {
-            return first != second;
+            return !(first == second);
         }
 
         friend Rational operator+(const Rational& first, const Rational& second) {
-            return first.value_ + second.value_;
+            Rational result = first;
+            result += second;
+            return result;
         }
 
         Rational operator+=(const Rational& other) {
-            value_ = value_ + other.value_;
+            if (big_ || other.big_ || !add_small(other.numerator_, other.denominator_)) {
+                apply_big(other, [] (RationalType& first, const RationalType& second) {
+                    first += second;
+                });
+            }
             return *this;
         }
 
         friend Rational operator-(const Rational& first, const Rational& second) {
-            return first.value_ - second.value_;
+            Rational result = first;
+            result -= second;
+            return result;
         }
 
         Rational operator-=(const Rational& other) {
-            value_ = value_ - other.value_;
+            if (big_ || other.big_ || !add_small(-other.numerator_, other.denominator_)) {
+                apply_big(other, [] (RationalType& first, const RationalType& second) {
+                    first -= second;
+                });
+            }
             return *this;
         }
 
         friend Rational operator*(const Rational& first, const Rational& second) {
-            return first.value_ * second.value_;
+            Rational result = first;
+            result *= second;
+            return result;
         }
 
         Rational operator*=(const Rational& other) {
-            value_ = value_ * other.value_;
+            if (big_ || other.big_ || !multiply_small(other.numerator_, other.denominator_)) {
+                apply_big(other, [] (RationalType& first, const RationalType& second) {
+                    first *= second;
+                });
+            }
             return *this;
         }
 
         friend Rational operator/(const Rational& first, const Rational& second) {
-            return first.value_ / second.value_;
+            Rational result = first;
+            result /= second;
+            return result;
         }
 
         Rational operator/=(const Rational& other) {
-            value_ = value_ / other.value_;
+            assert(((void)"division by zero", !other.is_zero()));
+            const bool is_negative = other.numerator_ < 0;
+            if (big_ || other.big_ || !multiply_small(is_negative ? -other.denominator_ : other.denominator_, is_negative ? -other.numerator_ : other.numerator_)) {
+                apply_big(other, [] (RationalType& first, const RationalType& second) {
+                    first /= second;
+                });
+            }
             return *this;
         }
 
         friend std::ostream& operator<<(std::ostream& out, const Rational& element) {
-            if (element.value_ < 0) {
-                out << "(" << element.value_ << ")";
-            } else {
-                out << element.value_;
+            if (element.big_) {
+                if (*element.big_ < 0) {
+                    out << "(" << *element.big_ << ")";
+                } else {
+                    out << *element.big_;
+                }
+                return out;
+            }
+            if (element.numerator_ < 0) {
+                out << "(";
+            }
+            out << element.numerator_;
+            if (element.denominator_ != 1) {
+                out << "/" << element.denominator_;
+            }
+            if (element.numerator_ < 0) {
+                out << ")";
             }
             return out;
         }
 
         bool is_zero() const {
-            return value_ == 0;
+            return !big_ && numerator_ == 0;
         }
 
         bool is_one() const {
-            return value_ == 1;
+            return !big_ && numerator_ == 1 && denominator_ == 1;
+        }
+
+        IntegerType get_numerator() const {
+            return big_ ? boost::multiprecision::numerator(*big_) : IntegerType(numerator_);
+        }
+
+        IntegerType get_denominator() const {
+            return big_ ? boost::multiprecision::denominator(*big_) : IntegerType(denominator_);
+        }
+
+        RationalType get_value() const {
+            return big_ ? *big_ : to_big();
+        }
+
+    private:
+        // -SMALL_LIMIT is the least inline value, so the negation never overflows.
+        static constexpr int64_t SMALL_LIMIT = std::numeric_limits<int64_t>::max();
+
+        template <typename T>
+        static bool is_small(T value) {
+            if constexpr (std::is_signed_v<T>) {
+                return value >= -SMALL_LIMIT && value <= SMALL_LIMIT;
+            } else {
+                return value <= static_cast<uint64_t>(SMALL_LIMIT);
+            }
+        }
+
+        RationalType to_big() const {
+            RationalType result;
+            mpq_set_si(result.backend().data(), numerator_, static_cast<unsigned long>(denominator_));
+            return result;
+        }
+
+        // With g = gcd(b, d) the sum a/b + c/d = (a * (d/g) + c * (b/g)) / (b * (d/g)), and the gcd of
+        // the new numerator and the new denominator divides g.
+        bool add_small(int64_t numerator, int64_t denominator) {
+            const int64_t divisor = std::gcd(denominator_, denominator);
+            int64_t first;
+            int64_t second;
+            int64_t result_numerator;
+            int64_t result_denominator;
+            if (__builtin_mul_overflow(numerator_, denominator / divisor, &first) ||
+                __builtin_mul_overflow(numerator, denominator_ / divisor, &second) ||
+                __builtin_add_overflow(first, second, &result_numerator) ||
+                __builtin_mul_overflow(denominator_, denominator / divisor, &result_denominator) ||
+                !is_small(result_numerator)) {
+                return false;
+            }
+            if (result_numerator == 0) {
+                numerator_ = 0;
+                denominator_ = 1;
+                return true;
+            }
+            const int64_t common = std::gcd(result_numerator, divisor);
+            numerator_ = result_numerator / common;
+            denominator_ = result_denominator / common;
+            return true;
+        }
+
+        // The denominator is positive, the fractions a/d and c/b are reduced before the multiplication.
+        bool multiply_small(int64_t numerator, int64_t denominator) {
+            if (numerator_ == 0 || numerator == 0) {
+                numerator_ = 0;
+                denominator_ = 1;
+                return true;
+            }
+            const int64_t first = std::gcd(numerator_, denominator);
+            const int64_t second = std::gcd(numerator, denominator_);
+            int64_t result_numerator;
+            int64_t result_denominator;
+            if (__builtin_mul_overflow(numerator_ / first, numerator / second, &result_numerator) ||
+                __builtin_mul_overflow(denominator_ / second, denominator / first, &result_denominator) ||
+                !is_small(result_numerator)) {
+                return false;
+            }
+            numerator_ = result_numerator;
+            denominator_ = result_denominator;
+            return true;
+        }
+
+        // The operation is done in place in GMP.
+        template <class Operation>
+        void apply_big(const Rational& other, Operation operation) {
+            if (!big_) {
+                big_.emplace(to_big());
+            }
+            if (other.big_) {
+                operation(*big_, *other.big_);
+            } else {
+                operation(*big_, other.to_big());
+            }
+            normalize();
+        }
+
+        void normalize() {
+            const mpz_srcptr numerator = mpq_numref(big_->backend().data());
+            const mpz_srcptr denominator = mpq_denref(big_->backend().data());
+            if (!mpz_fits_slong_p(numerator) || !mpz_fits_slong_p(denominator) || mpz_cmp_si(numerator, -SMALL_LIMIT) < 0) {
+                return;
+            }
+            numerator_ = mpz_get_si(numerator);
+            denominator_ = mpz_get_si(denominator);
+            big_.reset();
         }
 
-        RationalType value_ = 0;
+        int64_t numerator_ = 0;
+        int64_t denominator_ = 1;
+        std::optional<RationalType> big_;
     };
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,177 @@
+#ifndef GROEBNER_BASIS_ROW_KERNELS_H
+#define GROEBNER_BASIS_ROW_KERNELS_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__GNUC__) && defined(__x86_64__)
+#define GROEBNER_BASIS_AVX2_KERNELS
+#include <immintrin.h>
+#endif
+
+namespace math {
+
+    constexpr uint32_t ROW_KERNELS_MODULO_LIMIT = 1u << 31u;
+
+    /*
+     * Row operations on residues modulo a prime less than 2^31. The product of a residue x by a
+     * factor c fixed for the whole row is found by the method of Shoup: with c' = floor(c * 2^32 / modulo)
+     * and q = floor(x * c' / 2^32) the value x * c - q * modulo lies in [0, 2 * modulo), so it is
+     * computed by 32-bit multiplications modulo 2^32 and one subtraction. The AVX2 kernels process
+     * 8 residues at once, they are used if the processor supports them.
+     */
+    enum class RowKernels {
+        Scalar,
+        AVX2
+    };
+
+    std::ostream& operator<<(std::ostream& out, RowKernels kernels) {
+        out << (kernels == RowKernels::AVX2 ? "avx2" : "scalar");
+        return out;
+    }
+
+    // The fastest kernels supported by the processor.
+    RowKernels get_row_kernels() {
+#ifdef GROEBNER_BASIS_AVX2_KERNELS
+        static const RowKernels result = __builtin_cpu_supports("avx2") ? RowKernels::AVX2 : RowKernels::Scalar;
+        return result;
+#else
+        return RowKernels::Scalar;
+#endif
+    }
+
+    uint32_t get_shoup_factor(uint32_t factor, uint32_t modulo) {
+        return static_cast<uint32_t>((static_cast<uint64_t>(factor) << 32u) / modulo);
+    }
+
+    uint32_t multiply_shoup(uint32_t value, uint32_t factor, uint32_t shoup_factor, uint32_t modulo) {
+        const auto quotient = static_cast<uint32_t>((static_cast<uint64_t>(value) * shoup_factor) >> 32u);
+        const uint32_t result = value * factor - quotient * modulo;
+        return result >= modulo ? result - modulo : result;
+    }
+
+#ifdef GROEBNER_BASIS_AVX2_KERNELS
+    // The minimum of x and x - modulo modulo 2^32 is x reduced once, if x < 2 * modulo.
+    __attribute__((target("avx2")))
+    __m256i reduce_once_avx2(__m256i value, __m256i modulo) {
+        return _mm256_min_epu32(value, _mm256_sub_epi32(value, modulo));
+    }
+
+    __attribute__((target("avx2")))
+    __m256i multiply_shoup_avx2(__m256i value, __m256i factor, __m256i shoup_factor, __m256i modulo) {
+        const __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(value, shoup_factor), 32);
+        const __m256i odd = _mm256_mul_epu32(_mm256_srli_epi64(value, 32), shoup_factor);
+        const __m256i quotient = _mm256_blend_epi32(even, odd, 0xAA);
+        const __m256i result = _mm256_sub_epi32(_mm256_mullo_epi32(value, factor), _mm256_mullo_epi32(quotient, modulo));
+        return reduce_once_avx2(result, modulo);
+    }
+
+    // The kernels process the longest prefix of a multiple of the vector length and return its length.
+    __attribute__((target("avx2")))
+    size_t subtract_scaled_row_avx2(uint32_t* row, const uint32_t* pivot, size_t size, uint32_t factor, uint32_t shoup_factor, uint32_t modulo) {
+        const __m256i factors = _mm256_set1_epi32(static_cast<int>(factor));
+        const __m256i shoup_factors = _mm256_set1_epi32(static_cast<int>(shoup_factor));
+        const __m256i moduli = _mm256_set1_epi32(static_cast<int>(modulo));
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            const __m256i product = multiply_shoup_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(pivot + i)), factors, shoup_factors, moduli);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), reduce_once_avx2(_mm256_add_epi32(current, product), moduli));
+        }
+        return i;
+    }
+
+    __attribute__((target("avx2")))
+    size_t scale_row_avx2(uint32_t* row, size_t size, uint32_t factor, uint32_t shoup_factor, uint32_t modulo) {
+        const __m256i factors = _mm256_set1_epi32(static_cast<int>(factor));
+        const __m256i shoup_factors = _mm256_set1_epi32(static_cast<int>(shoup_factor));
+        const __m256i moduli = _mm256_set1_epi32(static_cast<int>(modulo));
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            const __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(row + i), multiply_shoup_avx2(current, factors, shoup_factors, moduli));
+        }
+        return i;
+    }
+
+    // AVX2 has no scatter, the updated sums are stored one by one.
+    __attribute__((target("avx2")))
+    size_t add_scaled_sparse_row_avx2(uint64_t* sums, const uint32_t* columns, const uint32_t* values, size_t size, uint32_t factor, uint64_t reduction) {
+        const __m256i factors = _mm256_set1_epi64x(factor);
+        const __m256i reductions = _mm256_set1_epi64x(static_cast<long long>(reduction));
+        const __m256i zero = _mm256_setzero_si256();
+        alignas(32) uint64_t buffer[4];
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            const __m128i indices = _mm_loadu_si128(reinterpret_cast<const __m128i*>(columns + i));
+            const __m256i current = _mm256_i32gather_epi64(reinterpret_cast<const long long*>(sums), indices, 8);
+            const __m256i products = _mm256_mul_epu32(_mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i))), factors);
+            const __m256i sum = _mm256_add_epi64(current, products);
+            // The sums not less than 2^63 are negative as signed numbers.
+            const __m256i reduced = _mm256_sub_epi64(sum, _mm256_and_si256(_mm256_cmpgt_epi64(zero, sum), reductions));
+            _mm256_store_si256(reinterpret_cast<__m256i*>(buffer), reduced);
+            for (size_t j = 0; j < 4; ++j) {
+                sums[columns[i + j]] = buffer[j];
+            }
+        }
+        return i;
+    }
+#endif
+
+    // row = row - factor * pivot, the residues of both rows and the factor are less than the modulo.
+    void subtract_scaled_row(uint32_t* row, const uint32_t* pivot, size_t size, uint32_t factor, uint32_t modulo, RowKernels kernels = get_row_kernels()) {
+        assert(((void)"modulo should be less than 2^31", modulo < ROW_KERNELS_MODULO_LIMIT));
+        const uint32_t negated = factor == 0 ? 0 : modulo - factor;
+        const uint32_t shoup_factor = get_shoup_factor(negated, modulo);
+        size_t i = 0;
+#ifdef GROEBNER_BASIS_AVX2_KERNELS
+        if (kernels == RowKernels::AVX2) {
+            i = subtract_scaled_row_avx2(row, pivot, size, negated, shoup_factor, modulo);
+        }
+#endif
+        for (; i < size; ++i) {
+            const uint32_t sum = row[i] + multiply_shoup(pivot[i], negated, shoup_factor, modulo);
+            row[i] = sum >= modulo ? sum - modulo : sum;
+        }
+    }
+
+    // row = factor * row, normalizes the row if the factor is the inverse of its major coefficient.
+    void scale_row(uint32_t* row, size_t size, uint32_t factor, uint32_t modulo, RowKernels kernels = get_row_kernels()) {
+        assert(((void)"modulo should be less than 2^31", modulo < ROW_KERNELS_MODULO_LIMIT));
+        const uint32_t shoup_factor = get_shoup_factor(factor, modulo);
+        size_t i = 0;
+#ifdef GROEBNER_BASIS_AVX2_KERNELS
+        if (kernels == RowKernels::AVX2) {
+            i = scale_row_avx2(row, size, factor, shoup_factor, modulo);
+        }
+#endif
+        for (; i < size; ++i) {
+            row[i] = multiply_shoup(row[i], factor, shoup_factor, modulo);
+        }
+    }
+
+    /*
+     * Adds factor * values[i] to the sums of the distinct columns[i] of a dense row with delayed
+     * reduction: the sums are kept less than 2^63 by subtracting the reduction, the greatest multiple
+     * of the modulo not greater than 2^63. The columns and the residues should be less than 2^31.
+     */
+    void add_scaled_sparse_row(uint64_t* sums, const uint32_t* columns, const uint32_t* values, size_t size, uint32_t factor, uint64_t reduction, RowKernels kernels = get_row_kernels()) {
+        size_t i = 0;
+#ifdef GROEBNER_BASIS_AVX2_KERNELS
+        if (kernels == RowKernels::AVX2) {
+            i = add_scaled_sparse_row_avx2(sums, columns, values, size, factor, reduction);
+        }
+#endif
+        for (; i < size; ++i) {
+            uint64_t& sum = sums[columns[i]];
+            sum += static_cast<uint64_t>(factor) * values[i];
+            if (sum >= (uint64_t(1) << 63u)) {
+                sum -= reduction;
+            }
+        }
+    }
+}
+
+#endif
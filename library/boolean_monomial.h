@@ -0,0 +1,340 @@
+#ifndef GROEBNER_BASIS_BOOLEAN_MONOMIAL_H
+#define GROEBNER_BASIS_BOOLEAN_MONOMIAL_H
+
+#include "../fields/boolean.h"
+#include "monomial.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <initializer_list>
+#include <iostream>
+#include <vector>
+
+namespace polynomial {
+
+    using BooleanMonomialWordType = uint64_t;
+
+    /*
+     * Monomials of the boolean polynomials: the field equations x_i^2 = x_i hold, so a monomial is
+     * the set of its variables, kept as a bitset of 64-bit words. The product is the union of the
+     * sets and a monomial divides another one if it is a subset of it, both take one operation per
+     * word. Monomials with at most BOOLEAN_MONOMIAL_INLINE_WORDS words are stored inline, longer
+     * ones on the heap, the representation is canonical: there are no zero words at the end.
+     */
+    constexpr size_t BOOLEAN_MONOMIAL_WORD_BITS = 64;
+    constexpr size_t BOOLEAN_MONOMIAL_INLINE_WORDS = 2;
+
+    class BooleanMonomial {
+    public:
+        /*
+         * The product of multilinear monomials doesn't preserve their order, for example x_1 < x_0
+         * but x_0 * x_1 > x_0 * x_0 = x_0. The product by a monomial disjoint from the major monomial
+         * of a polynomial keeps it major, so the reductions work, but the other terms are re-sorted.
+         */
+        static constexpr bool IS_MULTILINEAR = true;
+
+        BooleanMonomial() = default;
+
+        // Every nonzero exponent is 1 by the field equations.
+        BooleanMonomial(std::vector<MonomialDegreeType>&& degree) {
+            assign(degree.data(), degree.size());
+        }
+
+        BooleanMonomial(std::initializer_list<MonomialDegreeType> degree) {
+            assign(degree.begin(), degree.size());
+        }
+
+        BooleanMonomial(const BooleanMonomial& other) {
+            copy_from(other);
+        }
+
+        BooleanMonomial(BooleanMonomial&& other) noexcept {
+            move_from(other);
+        }
+
+        BooleanMonomial& operator=(const BooleanMonomial& other) {
+            if (this != &other) {
+                release();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        BooleanMonomial& operator=(BooleanMonomial&& other) noexcept {
+            if (this != &other) {
+                release();
+                move_from(other);
+            }
+            return *this;
+        }
+
+        ~BooleanMonomial() {
+            release();
+        }
+
+        friend bool operator==(const BooleanMonomial& first, const BooleanMonomial& second) {
+            if (first.total_degree_ != second.total_degree_ || first.words_count_ != second.words_count_) {
+                return false;
+            }
+            return std::equal(first.get_words(), first.get_words() + first.words_count_, second.get_words());
+        }
+
+        friend bool operator!=(const BooleanMonomial& first, const BooleanMonomial& second) {
+            return !(first == second);
+        }
+
+        // Lexicographic order with x_0 > x_1 > ..., like for Monomial.
+        friend bool operator<(const BooleanMonomial& first, const BooleanMonomial& second) {
+            const size_t common = std::min(first.words_count_, second.words_count_);
+            const BooleanMonomialWordType* first_words = first.get_words();
+            const BooleanMonomialWordType* second_words = second.get_words();
+            for (size_t i = 0; i < common; ++i) {
+                const BooleanMonomialWordType difference = first_words[i] ^ second_words[i];
+                if (difference != 0) {
+                    return (second_words[i] & difference & (~difference + 1)) != 0;
+                }
+            }
+            return first.words_count_ < second.words_count_;
+        }
+
+        friend BooleanMonomial operator*(const BooleanMonomial& first, const BooleanMonomial& second) {
+            BooleanMonomial result(first);
+            result *= second;
+            return result;
+        }
+
+        BooleanMonomial& operator*=(const BooleanMonomial& other) {
+            if (words_count_ < other.words_count_) {
+                resize(other.words_count_);
+            }
+            BooleanMonomialWordType* words = get_words();
+            const BooleanMonomialWordType* other_words = other.get_words();
+            for (size_t i = 0; i < other.words_count_; ++i) {
+                words[i] |= other_words[i];
+            }
+            update_degree();
+            return *this;
+        }
+
+        friend BooleanMonomial operator/(const BooleanMonomial& first, const BooleanMonomial& second) {
+            BooleanMonomial result(first);
+            result /= second;
+            return result;
+        }
+
+        BooleanMonomial& operator/=(const BooleanMonomial& other) {
+            assert(((void)"divider should be a subset of dividend", is_subset(other)));
+            BooleanMonomialWordType* words = get_words();
+            const BooleanMonomialWordType* other_words = other.get_words();
+            for (size_t i = 0; i < other.words_count_; ++i) {
+                words[i] &= ~other_words[i];
+            }
+            normalize();
+            return *this;
+        }
+
+        // The number of variables up to the last one of the monomial.
+        size_t size() const {
+            if (words_count_ == 0) {
+                return 0;
+            }
+            const auto last = static_cast<size_t>(__builtin_clzll(get_words()[words_count_ - 1]));
+            return words_count_ * BOOLEAN_MONOMIAL_WORD_BITS - last;
+        }
+
+        bool is_subset(const BooleanMonomial& other) const {
+            if (words_count_ < other.words_count_ || total_degree_ < other.total_degree_) {
+                return false;
+            }
+            const BooleanMonomialWordType* words = get_words();
+            const BooleanMonomialWordType* other_words = other.get_words();
+            for (size_t i = 0; i < other.words_count_; ++i) {
+                if ((other_words[i] & ~words[i]) != 0) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool is_empty() const {
+            return words_count_ == 0;
+        }
+
+        MonomialDegreeType get_total_degree() const {
+            return total_degree_;
+        }
+
+        MonomialDegreeType get_degree(size_t num) const {
+            return static_cast<MonomialDegreeType>((get_word(num / BOOLEAN_MONOMIAL_WORD_BITS) >> (num % BOOLEAN_MONOMIAL_WORD_BITS)) & 1u);
+        }
+
+        friend std::ostream& operator<<(std::ostream& out, const BooleanMonomial& element) {
+            if (element.is_empty()) {
+                out << "1";
+                return out;
+            }
+            bool is_first = true;
+            for (size_t i = 0; i < element.words_count_; ++i) {
+                for (BooleanMonomialWordType word = element.get_words()[i]; word != 0; word &= word - 1) {
+                    if (!is_first) {
+                        out << "*";
+                    }
+                    is_first = false;
+                    print_variable(out, i * BOOLEAN_MONOMIAL_WORD_BITS + static_cast<size_t>(__builtin_ctzll(word)));
+                }
+            }
+            return out;
+        }
+
+        // Three-way comparison of GrevlexOrder for monomials of equal degrees, by the last different variable.
+        int compare_reverse(const BooleanMonomial& other) const {
+            for (size_t i = std::max(words_count_, other.words_count_); i > 0; --i) {
+                const BooleanMonomialWordType word = get_word(i - 1);
+                const BooleanMonomialWordType difference = word ^ other.get_word(i - 1);
+                if (difference != 0) {
+                    const auto last = BOOLEAN_MONOMIAL_WORD_BITS - 1 - static_cast<size_t>(__builtin_clzll(difference));
+                    return ((word >> last) & 1u) != 0 ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        friend BooleanMonomial get_intersection(const BooleanMonomial& first, const BooleanMonomial& second);
+
+        friend BooleanMonomial get_union(const BooleanMonomial& first, const BooleanMonomial& second);
+
+    private:
+        bool is_inline() const {
+            return words_count_ <= BOOLEAN_MONOMIAL_INLINE_WORDS;
+        }
+
+        BooleanMonomialWordType* get_words() {
+            return is_inline() ? inline_ : wide_;
+        }
+
+        const BooleanMonomialWordType* get_words() const {
+            return is_inline() ? inline_ : wide_;
+        }
+
+        BooleanMonomialWordType get_word(size_t num) const {
+            return num < words_count_ ? get_words()[num] : 0;
+        }
+
+        template <class Iterator>
+        void assign(Iterator degree, size_t size) {
+            resize((size + BOOLEAN_MONOMIAL_WORD_BITS - 1) / BOOLEAN_MONOMIAL_WORD_BITS);
+            BooleanMonomialWordType* words = get_words();
+            for (size_t i = 0; i < size; ++i) {
+                if (degree[i] > 0) {
+                    words[i / BOOLEAN_MONOMIAL_WORD_BITS] |= BooleanMonomialWordType(1) << (i % BOOLEAN_MONOMIAL_WORD_BITS);
+                }
+            }
+            normalize();
+        }
+
+        // Changes the number of words, the added words are zero.
+        void resize(size_t count) {
+            if (count <= BOOLEAN_MONOMIAL_INLINE_WORDS) {
+                if (!is_inline()) {
+                    BooleanMonomialWordType* wide = wide_;
+                    std::copy(wide, wide + count, inline_);
+                    delete[] wide;
+                } else {
+                    std::fill(inline_ + std::min<size_t>(words_count_, count), inline_ + count, 0);
+                }
+            } else {
+                auto* wide = new BooleanMonomialWordType[count];
+                const size_t common = std::min<size_t>(words_count_, count);
+                std::copy(get_words(), get_words() + common, wide);
+                std::fill(wide + common, wide + count, 0);
+                if (!is_inline()) {
+                    delete[] wide_;
+                }
+                wide_ = wide;
+            }
+            words_count_ = static_cast<uint32_t>(count);
+        }
+
+        // Drops the zero words at the end and updates the degree.
+        void normalize() {
+            size_t count = words_count_;
+            while (count > 0 && get_words()[count - 1] == 0) {
+                --count;
+            }
+            resize(count);
+            update_degree();
+        }
+
+        void update_degree() {
+            total_degree_ = 0;
+            const BooleanMonomialWordType* words = get_words();
+            for (size_t i = 0; i < words_count_; ++i) {
+                total_degree_ += static_cast<MonomialDegreeType>(__builtin_popcountll(words[i]));
+            }
+        }
+
+        void copy_from(const BooleanMonomial& other) {
+            words_count_ = other.words_count_;
+            total_degree_ = other.total_degree_;
+            if (is_inline()) {
+                std::copy(other.inline_, other.inline_ + words_count_, inline_);
+            } else {
+                wide_ = new BooleanMonomialWordType[words_count_];
+                std::copy(other.wide_, other.wide_ + words_count_, wide_);
+            }
+        }
+
+        void move_from(BooleanMonomial& other) {
+            words_count_ = other.words_count_;
+            total_degree_ = other.total_degree_;
+            if (is_inline()) {
+                std::copy(other.inline_, other.inline_ + words_count_, inline_);
+            } else {
+                wide_ = other.wide_;
+                other.words_count_ = 0;
+                other.total_degree_ = 0;
+            }
+        }
+
+        void release() {
+            if (!is_inline()) {
+                delete[] wide_;
+                words_count_ = 0;
+                total_degree_ = 0;
+            }
+        }
+
+        uint32_t words_count_ = 0;
+        MonomialDegreeType total_degree_ = 0;
+        union {
+            BooleanMonomialWordType inline_[BOOLEAN_MONOMIAL_INLINE_WORDS];
+            BooleanMonomialWordType* wide_;
+        };
+    };
+
+    BooleanMonomial get_intersection(const BooleanMonomial& first, const BooleanMonomial& second) {
+        BooleanMonomial result;
+        result.resize(std::min(first.words_count_, second.words_count_));
+        BooleanMonomialWordType* words = result.get_words();
+        for (size_t i = 0; i < result.words_count_; ++i) {
+            words[i] = first.get_words()[i] & second.get_words()[i];
+        }
+        result.normalize();
+        return result;
+    }
+
+    // The least common multiple, the counterpart of get_intersection.
+    BooleanMonomial get_union(const BooleanMonomial& first, const BooleanMonomial& second) {
+        BooleanMonomial result(first.words_count_ < second.words_count_ ? second : first);
+        result *= (first.words_count_ < second.words_count_ ? first : second);
+        return result;
+    }
+
+    template <>
+    struct FieldMonomial<math::Boolean> {
+        using Type = BooleanMonomial;
+    };
+}
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef GROEBNER_BASIS_DIVISIBILITY_H
+#define GROEBNER_BASIS_DIVISIBILITY_H
+
+#include "monomial.h"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    // The first monomials of the index are checked one by one, they are the most frequent divisors.
+    constexpr size_t DIVISIBILITY_SCAN_LENGTH = 128;
+
+    /*
+     * Index of monomials numbered by the order of insertion, answers which of them divide a given
+     * monomial. The monomials are kept in a trie by the exponents of the variables, the children
+     * of a node are sorted by the exponent, so a search only goes into the children with exponents
+     * not greater than the exponent of the divided monomial. Every node knows the least number in
+     * its subtree, so the search for the least divisor skips the subtrees which can't improve it.
+     * The least divisor is usually one of the oldest monomials, so they are scanned before the trie.
+     */
+    template <class MonomialType = Monomial>
+    class DivisibilityIndex {
+    public:
+        static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+        DivisibilityIndex() : nodes_(1) {}
+
+        size_t size() const {
+            return size_;
+        }
+
+        void clear() {
+            nodes_.assign(1, Node());
+            first_.clear();
+            size_ = 0;
+        }
+
+        // Adds the monomial with the number size().
+        void insert(const MonomialType& monomial) {
+            const size_t number = size_++;
+            if (first_.size() < DIVISIBILITY_SCAN_LENGTH) {
+                first_.push_back(monomial);
+            }
+            size_t length = monomial.size();
+            while (length > 0 && monomial.get_degree(length - 1) == 0) {
+                --length;
+            }
+            size_t node = 0;
+            for (size_t i = 0; i < length; ++i) {
+                nodes_[node].least = std::min(nodes_[node].least, number);
+                node = get_child(node, monomial.get_degree(i));
+            }
+            nodes_[node].least = std::min(nodes_[node].least, number);
+            nodes_[node].numbers.push_back(number);
+        }
+
+        // The least number of a divisor of the monomial, or NONE.
+        size_t find_divisor(const MonomialType& monomial) const {
+            return find_divisor(monomial, [] (size_t) {
+                return true;
+            });
+        }
+
+        // The least number of a divisor of the monomial satisfying the predicate, or NONE.
+        template <class Predicate>
+        size_t find_divisor(const MonomialType& monomial, Predicate predicate) const {
+            for (size_t i = 0; i < first_.size(); ++i) {
+                if (monomial.is_subset(first_[i]) && predicate(i)) {
+                    return i;
+                }
+            }
+            size_t result = NONE;
+            find(0, 0, monomial, predicate, result);
+            return result;
+        }
+
+    private:
+        struct Node {
+            // Children by the exponent of the next variable, sorted by the exponent.
+            std::vector<std::pair<MonomialDegreeType, size_t>> children;
+            // Numbers of the monomials with no more nonzero exponents.
+            std::vector<size_t> numbers;
+            size_t least = NONE;
+        };
+
+        size_t get_child(size_t node, MonomialDegreeType degree) {
+            auto& children = nodes_[node].children;
+            auto child = std::lower_bound(children.begin(), children.end(), std::make_pair(degree, size_t(0)));
+            if (child != children.end() && child->first == degree) {
+                return child->second;
+            }
+            const size_t result = nodes_.size();
+            children.emplace(child, degree, result);
+            nodes_.emplace_back();
+            return result;
+        }
+
+        template <class Predicate>
+        void find(size_t node, size_t depth, const MonomialType& monomial, Predicate& predicate, size_t& result) const {
+            const Node& current = nodes_[node];
+            if (current.least >= result) {
+                return;
+            }
+            for (size_t number : current.numbers) {
+                if (number >= result) {
+                    break;
+                }
+                if (predicate(number)) {
+                    result = number;
+                    break;
+                }
+            }
+            const MonomialDegreeType degree = monomial.get_degree(depth);
+            for (const auto& child : current.children) {
+                if (child.first > degree) {
+                    break;
+                }
+                find(child.second, depth + 1, monomial, predicate, result);
+            }
+        }
+
+        std::vector<Node> nodes_;
+        std::vector<MonomialType> first_;
+        size_t size_ = 0;
+    };
+}
+
+#endif
@@ -0,0 +1,173 @@
+#ifndef GROEBNER_BASIS_F4_H
+#define GROEBNER_BASIS_F4_H
+
+#include "monomial.h"
+#include "polynomial.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    /*
+     * Macaulay matrix of the F4 algorithm. The rows are products multiplier * polynomial of monic
+     * basis elements, the columns are the monomials of the rows from the major one. Symbolic
+     * preprocessing adds a reducer row for every column divisible by a major monomial of the
+     * basis, so that after the reduction to the row echelon form the major monomials of the new
+     * rows are not divisible by any major monomial of the basis.
+     */
+    template <class PolynomialType>
+    class MacaulayMatrix {
+    public:
+        using FieldType = typename PolynomialType::FieldType;
+        using CompareType = typename PolynomialType::CompareType;
+        using MonomialType = typename PolynomialType::MonomialType;
+
+        void add_row(const PolynomialType& polynomial, const MonomialType& multiplier) {
+            if (!row_keys_.emplace(&polynomial, multiplier).second) {
+                return;
+            }
+            rows_.push_back({&polynomial, multiplier});
+            auto hint = columns_.begin();
+            for (const auto& term : polynomial) {
+                hint = std::next(columns_.emplace_hint(hint, term.first * multiplier, 0));
+            }
+            ++std::prev(hint)->second;
+        }
+
+        // Adds reducer rows, find_reducer returns a basis element dividing the monomial or nullptr.
+        template <class ReducerFinder>
+        void preprocess(ReducerFinder find_reducer) {
+            auto column = columns_.end();
+            while (column != columns_.begin()) {
+                --column;
+                if (column->second > 0) {
+                    continue;
+                }
+                const PolynomialType* reducer = find_reducer(column->first);
+                if (reducer != nullptr) {
+                    add_row(*reducer, column->first / reducer->get_major_monomial());
+                }
+            }
+        }
+
+        // Reduces the matrix to the row echelon form, returns the rows with new major monomials.
+        std::vector<PolynomialType> reduce() {
+            const size_t columns_count = columns_.size();
+            assert(((void)"the number of columns should be less than 2^31", columns_count < (1u << 31u)));
+            std::vector<const MonomialType*> monomials(columns_count);
+            size_t number = columns_count;
+            for (auto& column : columns_) {
+                monomials[--number] = &column.first;
+                column.second = number;
+            }
+            std::vector<SparseRow> pivots(columns_count);
+            std::vector<SparseRow> pending;
+            MonomialType shifted;
+            for (const auto& row : rows_) {
+                SparseRow sparse;
+                sparse.columns.reserve(row.polynomial->get_terms_count());
+                sparse.values.reserve(row.polynomial->get_terms_count());
+                for (const auto& term : *row.polynomial) {
+                    shifted = term.first;
+                    shifted *= row.multiplier;
+                    sparse.columns.push_back(static_cast<uint32_t>(columns_.find(shifted)->second));
+                    sparse.values.push_back(term.second);
+                }
+                std::reverse(sparse.columns.begin(), sparse.columns.end());
+                std::reverse(sparse.values.begin(), sparse.values.end());
+                auto& pivot = pivots[sparse.columns.front()];
+                if (pivot.columns.empty()) {
+                    pivot = std::move(sparse);
+                } else {
+                    pending.push_back(std::move(sparse));
+                }
+            }
+            std::stable_sort(pending.begin(), pending.end(), [] (const SparseRow& left, const SparseRow& right) {
+                return left.columns.front() < right.columns.front();
+            });
+            std::vector<PolynomialType> result;
+            // The entries are reduced once, when the reduction reaches their column.
+            std::vector<AccumulatorType> dense(columns_count);
+            std::vector<FieldType> values(columns_count);
+            for (const auto& row : pending) {
+                const size_t from = row.columns.front();
+                std::fill(dense.begin() + from, dense.end(), AccumulatorType());
+                for (size_t i = 0; i < row.columns.size(); ++i) {
+                    dense[row.columns[i]] = row.values[i];
+                }
+                size_t major = columns_count;
+                for (size_t i = from; i < columns_count; ++i) {
+                    values[i] = dense[i].get();
+                    const SparseRow& pivot = pivots[i];
+                    if (values[i].is_zero() || pivot.columns.empty()) {
+                        if (!values[i].is_zero() && major == columns_count) {
+                            major = i;
+                        }
+                        continue;
+                    }
+                    AccumulatorType::add_scaled_row(dense.data(), pivot.columns.data(), pivot.values.data(), pivot.columns.size(), FieldType() - values[i]);
+                    values[i] = FieldType();
+                }
+                if (major == columns_count) {
+                    ++zero_rows_count_;
+                    continue;
+                }
+                SparseRow& pivot = pivots[major];
+                for (size_t i = major; i < columns_count; ++i) {
+                    if (!values[i].is_zero()) {
+                        pivot.columns.push_back(static_cast<uint32_t>(i));
+                        pivot.values.push_back(values[i]);
+                    }
+                }
+                AccumulatorType::scale_row(pivot.values.data(), pivot.values.size(), FieldType(1) / values[major]);
+                PolynomialType polynomial;
+                for (size_t i = pivot.columns.size(); i > 0; --i) {
+                    polynomial.push_major_term(*monomials[pivot.columns[i - 1]], pivot.values[i - 1]);
+                }
+                result.push_back(std::move(polynomial));
+            }
+            return result;
+        }
+
+        size_t get_rows_count() const {
+            return rows_.size();
+        }
+
+        size_t get_columns_count() const {
+            return columns_.size();
+        }
+
+        size_t get_zero_rows_count() const {
+            return zero_rows_count_;
+        }
+
+    private:
+        struct Row {
+            const PolynomialType* polynomial;
+            MonomialType multiplier;
+        };
+
+        // The columns of the nonzero entries are increasing, the values are kept apart for the row kernels.
+        struct SparseRow {
+            std::vector<uint32_t> columns;
+            std::vector<FieldType> values;
+        };
+
+        using AccumulatorType = typename FieldAccumulator<FieldType>::Type;
+
+        std::vector<Row> rows_;
+        std::set<std::pair<const PolynomialType*, MonomialType>> row_keys_;
+        // The number of rows starting in the column, reduce replaces it by the number of the column.
+        std::map<MonomialType, size_t, CompareType> columns_;
+        size_t zero_rows_count_ = 0;
+    };
+}
+
+#endif
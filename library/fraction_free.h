@@ -0,0 +1,66 @@
+/*
+ * boost library should be installed to use these functions
+ */
+
+#ifndef GROEBNER_BASIS_FRACTION_FREE_H
+#define GROEBNER_BASIS_FRACTION_FREE_H
+
+#include "../fields/integer.h"
+#include "../fields/rational.h"
+#include "ideal.h"
+
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    // The integer multiple of the polynomial over the rationals by the lcm of its denominators.
+    template <class Compare, template <class, class> class Terms>
+    Polynomial<math::Integer, Compare, Terms> get_integer_polynomial(const Polynomial<math::Rational, Compare, Terms>& polynomial) {
+        math::IntegerType denominator = 1;
+        for (const auto& term : polynomial) {
+            denominator = boost::multiprecision::lcm(denominator, term.second.get_denominator());
+        }
+        Polynomial<math::Integer, Compare, Terms> result;
+        for (const auto& term : polynomial) {
+            result.push_major_term(term.first, math::Integer(math::IntegerType(term.second.get_numerator() * (denominator / term.second.get_denominator()))));
+        }
+        return result;
+    }
+
+    // The monic polynomial over the rationals proportional to the integer polynomial.
+    template <class Compare, template <class, class> class Terms>
+    Polynomial<math::Rational, Compare, Terms> get_monic_polynomial(const Polynomial<math::Integer, Compare, Terms>& polynomial) {
+        const math::IntegerType& major = polynomial.get_major_coefficient().get_value();
+        Polynomial<math::Rational, Compare, Terms> result;
+        for (const auto& term : polynomial) {
+            result.push_major_term(term.first, math::Rational(math::RationalType(term.second.get_value(), major)));
+        }
+        return result;
+    }
+
+    /*
+     * Replaces the ideal over the rationals by its reduced Groebner basis computed fraction-free:
+     * the generators are multiplied by the denominators, the basis over the integers is computed
+     * by the Buchberger engine with pseudo-reductions and content removal, and its primitive
+     * elements are made monic at the end. The rational numbers appear only in the last step, so
+     * most of the gcd computations of the rational arithmetic are skipped.
+     */
+    template <class Compare, template <class, class> class Terms>
+    void make_fraction_free_groebner_basis(Ideal<math::Rational, Compare, Terms>& ideal, size_t threads_count = 1) {
+        std::vector<Polynomial<math::Integer, Compare, Terms>> generators;
+        for (const auto& polynomial : ideal.get_basis()) {
+            generators.push_back(get_integer_polynomial(polynomial));
+        }
+        Ideal<math::Integer, Compare, Terms> integer_ideal(std::move(generators));
+        integer_ideal.set_threads_count(threads_count);
+        integer_ideal.make_minimal_groebner_basis();
+        std::vector<Polynomial<math::Rational, Compare, Terms>> basis;
+        for (const auto& polynomial : integer_ideal.get_basis()) {
+            basis.push_back(get_monic_polynomial(polynomial));
+        }
+        ideal.set_minimal_groebner_basis(std::move(basis));
+    }
+}
+
+#endif
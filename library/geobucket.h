@@ -0,0 +1,180 @@
+#ifndef GROEBNER_BASIS_GEOBUCKET_H
+#define GROEBNER_BASIS_GEOBUCKET_H
+
+#include "monomial.h"
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    /*
+     * Geobucket accumulator: a sum of polynomials kept in buckets, the i-th bucket holds at most
+     * GEOBUCKET_BASE^(i + 1) terms. Adding a polynomial merges it into a bucket of a similar length
+     * and carries the overflowed buckets upwards, so a long sum of short polynomials costs about
+     * the total length of the summands instead of their count times the length of the sum.
+     */
+    constexpr size_t GEOBUCKET_BASE = 4;
+
+    template <class PolynomialType>
+    class Geobucket {
+    public:
+        using FieldType = typename PolynomialType::FieldType;
+        using CompareType = typename PolynomialType::CompareType;
+        using MonomialType = typename PolynomialType::MonomialType;
+
+        Geobucket() = default;
+
+        explicit Geobucket(PolynomialType&& polynomial) {
+            add(std::move(polynomial));
+        }
+
+        void add(PolynomialType&& polynomial) {
+            if (polynomial.is_zero()) {
+                return;
+            }
+            restore_major();
+            size_t index = get_bucket(polynomial.get_terms_count());
+            if (buckets_[index].is_zero()) {
+                buckets_[index] = std::move(polynomial);
+            } else {
+                buckets_[index] += polynomial;
+            }
+            carry(index);
+        }
+
+        // Subtracts coefficient * monomial * polynomial, see Polynomial::subtract_multiple.
+        void subtract_multiple(const PolynomialType& polynomial, const MonomialType& monomial, const FieldType& coefficient, bool skip_major = false) {
+            if (polynomial.is_zero()) {
+                return;
+            }
+            restore_major();
+            size_t index = get_bucket(polynomial.get_terms_count());
+            buckets_[index].subtract_multiple(polynomial, monomial, coefficient, skip_major);
+            carry(index);
+        }
+
+        // Multiplies the sum by the nonzero coefficient.
+        void multiply(const FieldType& coefficient) {
+            if (coefficient.is_one()) {
+                return;
+            }
+            restore_major();
+            for (auto& bucket : buckets_) {
+                bucket *= coefficient;
+            }
+        }
+
+        bool is_zero() {
+            return !find_major();
+        }
+
+        const MonomialType& get_major_monomial() {
+            const bool is_found = find_major();
+            assert(((void)"the geobucket is empty", is_found));
+            return major_monomial_;
+        }
+
+        const FieldType& get_major_coefficient() {
+            const bool is_found = find_major();
+            assert(((void)"the geobucket is empty", is_found));
+            return major_coefficient_;
+        }
+
+        void pop_major() {
+            const bool is_found = find_major();
+            assert(((void)"the geobucket is empty", is_found));
+            has_major_ = false;
+        }
+
+        PolynomialType release() {
+            restore_major();
+            PolynomialType result;
+            for (auto& bucket : buckets_) {
+                if (result.get_terms_count() < bucket.get_terms_count()) {
+                    std::swap(result, bucket);
+                }
+                result += bucket;
+            }
+            buckets_.clear();
+            return result;
+        }
+
+    private:
+        size_t get_bucket(size_t terms_count) {
+            size_t index = 0;
+            for (size_t capacity = GEOBUCKET_BASE; capacity < terms_count; capacity *= GEOBUCKET_BASE) {
+                ++index;
+            }
+            if (index >= buckets_.size()) {
+                buckets_.resize(index + 1);
+            }
+            return index;
+        }
+
+        void carry(size_t index) {
+            size_t capacity = GEOBUCKET_BASE;
+            for (size_t i = 0; i < index; ++i) {
+                capacity *= GEOBUCKET_BASE;
+            }
+            while (buckets_[index].get_terms_count() > capacity) {
+                if (index + 1 == buckets_.size()) {
+                    buckets_.emplace_back();
+                }
+                if (buckets_[index + 1].is_zero()) {
+                    std::swap(buckets_[index], buckets_[index + 1]);
+                } else {
+                    buckets_[index + 1] += buckets_[index];
+                    buckets_[index] = PolynomialType();
+                }
+                ++index;
+                capacity *= GEOBUCKET_BASE;
+            }
+        }
+
+        // Collects the major term of the sum out of the buckets, returns false if the sum is zero.
+        bool find_major() {
+            CompareType cmp;
+            while (!has_major_) {
+                const PolynomialType* major = nullptr;
+                for (const auto& bucket : buckets_) {
+                    if (!bucket.is_zero() && (major == nullptr || cmp(major->get_major_monomial(), bucket.get_major_monomial()))) {
+                        major = &bucket;
+                    }
+                }
+                if (major == nullptr) {
+                    return false;
+                }
+                major_monomial_ = major->get_major_monomial();
+                major_coefficient_ = FieldType();
+                for (auto& bucket : buckets_) {
+                    if (!bucket.is_zero() && bucket.get_major_monomial() == major_monomial_) {
+                        const FieldType coefficient = bucket.get_major_coefficient();
+                        major_coefficient_ += coefficient;
+                        bucket.subtract(major_monomial_, coefficient);
+                    }
+                }
+                has_major_ = !major_coefficient_.is_zero();
+            }
+            return true;
+        }
+
+        void restore_major() {
+            if (has_major_) {
+                has_major_ = false;
+                if (buckets_.empty()) {
+                    buckets_.emplace_back();
+                }
+                buckets_[0].add(major_monomial_, major_coefficient_);
+            }
+        }
+
+        std::vector<PolynomialType> buckets_;
+        bool has_major_ = false;
+        MonomialType major_monomial_;
+        FieldType major_coefficient_;
+    };
+}
+
+#endif
@@ -1,9 +1,15 @@
 #ifndef GROEBNER_BASIS_IDEAL_H
 #define GROEBNER_BASIS_IDEAL_H
 
+#include "divisibility.h"
+#include "f4.h"
+#include "pairs.h"
 #include "polynomial.h"
+#include "signature.h"
+#include "thread_pool.h"
 
 #include <algorithm>
+#include <cassert>
 #include <vector>
 #include <initializer_list>
 
@@ -17,19 +23,94 @@ namespace polynomial {
         UniqueGroebner
     };
 
-    template<class Field, class Compare = std::less<Monomial>>
+    /*
+     * Algorithms of make_groebner_basis. Buchberger reduces the critical pairs one by one, F4
+     * takes all pairs of the least degree and reduces them at once as a Macaulay matrix,
+     * Signature skips the pairs which are known to reduce to zero by their signatures.
+     */
+    enum class GroebnerEngine {
+        Buchberger,
+        F4,
+        Signature
+    };
+
+    std::ostream& operator<<(std::ostream& out, GroebnerEngine engine) {
+        if (engine == GroebnerEngine::F4) {
+            out << "F4";
+        } else if (engine == GroebnerEngine::Signature) {
+            out << "signature";
+        } else {
+            out << "Buchberger";
+        }
+        return out;
+    }
+
+    // The bucket of a fraction-free reduction is divided by its content after every such number of steps.
+    constexpr size_t CONTENT_REMOVAL_PERIOD = 32;
+
+    // Counters of the last make_groebner_basis call.
+    struct GroebnerStats {
+        GroebnerEngine engine = GroebnerEngine::Buchberger;
+        SelectionStrategy strategy = SelectionStrategy::Normal;
+        size_t pairs_created = 0;
+        size_t pairs_reduced = 0;
+        size_t zero_reductions = 0;
+        size_t product_criterion = 0;
+        size_t chain_criterion = 0;
+        size_t matrices = 0;
+        size_t avoided_reductions = 0;
+        size_t threads = 1;
+        size_t installed = 0;
+        size_t multiples_reduced = 0;
+    };
+
+    std::ostream& operator<<(std::ostream& out, const GroebnerStats& stats) {
+        out << "engine: " << stats.engine;
+        if (stats.engine == GroebnerEngine::Signature) {
+            out << ", pairs created: " << stats.pairs_created;
+            out << ", pairs reduced: " << stats.pairs_reduced;
+            out << ", zero reductions: " << stats.zero_reductions;
+            out << ", avoided reductions: " << stats.avoided_reductions;
+            return out;
+        }
+        out << ", strategy: " << stats.strategy;
+        out << ", pairs created: " << stats.pairs_created;
+        out << ", pairs reduced: " << stats.pairs_reduced;
+        out << ", zero reductions: " << stats.zero_reductions;
+        out << ", pruned by product criterion: " << stats.product_criterion;
+        out << ", pruned by chain criterion: " << stats.chain_criterion;
+        if (stats.engine == GroebnerEngine::F4) {
+            out << ", matrices: " << stats.matrices;
+        }
+        if (stats.threads > 1) {
+            out << ", threads: " << stats.threads;
+        }
+        if (stats.installed > 0) {
+            out << ", installed elements: " << stats.installed;
+        }
+        if (stats.multiples_reduced > 0) {
+            out << ", multiples by field equations: " << stats.multiples_reduced;
+        }
+        return out;
+    }
+
+    template<class Field, class Compare = std::less<typename FieldMonomial<Field>::Type>, template <class, class> class Terms = MapTerms>
     class Ideal {
     public:
+        using PolynomialType = Polynomial<Field, Compare, Terms>;
+        using MonomialType = typename PolynomialType::MonomialType;
+
         Ideal() = default;
 
-        Ideal(std::vector<Polynomial<Field, Compare>>&& polynomials) : polynomials_(polynomials) {}
+        Ideal(std::vector<PolynomialType>&& polynomials) {
+            for (auto& polynomial : polynomials) {
+                insert(std::move(polynomial));
+            }
+        }
 
-        Ideal(std::initializer_list<Polynomial<Field, Compare>> polynomials) {
+        Ideal(std::initializer_list<PolynomialType> polynomials) {
             for (const auto& polynomial : polynomials) {
-                if (!polynomial.is_zero()) {
-                    polynomials_.push_back(polynomial);
-                    polynomials_.back() /= polynomials_.back().get_major_coefficient();
-                }
+                insert(polynomial);
             }
         }
 
@@ -44,106 +125,151 @@ namespace polynomial {
         }
 
         friend Ideal operator+(const Ideal& first, const Ideal& second) {
-            std::vector<Polynomial<Field, Compare>> result(first.polynomials_);
+            std::vector<PolynomialType> result(first.polynomials_);
             result.insert(result.end(), second.polynomials_.begin(), second.polynomials_.end());
             return std::move(result);
         }
 
         Ideal operator+=(const Ideal& other) {
             type_ = BasisType::Any;
-            polynomials_.insert(polynomials_.end(), other.polynomials_.begin(), other.polynomials_.end());
+            for (const auto& polynomial : other.polynomials_) {
+                insert(polynomial);
+            }
             return *this;
         }
 
-        void add(const Polynomial<Field, Compare>& polynomial) {
+        void add(const PolynomialType& polynomial) {
             type_ = BasisType::Any;
-            if (!polynomial.is_zero()) {
-                polynomials_.push_back(polynomial);
-                polynomials_.back() /= polynomials_.back().get_major_coefficient();
-            }
+            insert(polynomial);
         }
 
-        void reduce(Polynomial<Field, Compare>& polynomial) const {
-            while (!polynomial.is_zero()) {
-                const auto major_monomial = polynomial.get_major_monomial();
-                bool was_reduced = false;
-                for (const auto& reducer : polynomials_) {
-                    if (!major_monomial.is_subset(reducer.get_major_monomial())) {
-                        continue;
-                    }
-                    was_reduced = true;
-                    polynomial -= reducer * (major_monomial / reducer.get_major_monomial()) * polynomial.get_major_coefficient();
+        void set_selection_strategy(SelectionStrategy strategy) {
+            strategy_ = strategy;
+        }
+
+        /*
+         * With more than one thread the Buchberger engine reduces all pairs of the least degree at
+         * once against the current basis and appends the remainders in the order of the queue, so
+         * the reduced basis doesn't depend on the threads count.
+         */
+        void set_threads_count(size_t threads_count) {
+            threads_count_ = std::max<size_t>(threads_count, 1);
+        }
+
+        const GroebnerStats& get_stats() const {
+            return stats_;
+        }
+
+        /*
+         * Over a ring which is not a field the reduction is fraction-free, so the remainder is the
+         * remainder over the field of fractions multiplied by a nonzero constant.
+         */
+        void reduce(PolynomialType& polynomial) const {
+            Geobucket<PolynomialType> bucket(std::move(polynomial));
+            size_t steps = 0;
+            while (!bucket.is_zero()) {
+                const auto& major_monomial = bucket.get_major_monomial();
+                const PolynomialType* reducer = find_reducer(major_monomial);
+                if (reducer == nullptr) {
                     break;
                 }
-                if (!was_reduced) {
-                    break;
+                reduce_major(bucket, *reducer);
+                if constexpr (!IsField<Field>::value) {
+                    if (++steps % CONTENT_REMOVAL_PERIOD == 0) {
+                        auto current = bucket.release();
+                        const Field content = get_content(current);
+                        if (!content.is_zero() && !content.is_one()) {
+                            current /= content;
+                        }
+                        bucket = Geobucket<PolynomialType>(std::move(current));
+                    }
                 }
             }
+            polynomial = bucket.release();
         }
 
-        void full_reduce(Polynomial<Field, Compare>& polynomial) const {
-            while (!polynomial.is_zero()) {
-                bool was_reduced = false;
-                for (const auto& reducer : polynomials_) {
-                    const auto div = polynomial / reducer.get_major_monomial();
-                    if (div.is_zero()) {
-                        continue;
-                    }
-                    was_reduced = true;
-                    polynomial -= reducer * div;
-                }
-                if (!was_reduced) {
-                    break;
-                }
-            }
+        void full_reduce(PolynomialType& polynomial) const {
+            reduce_terms(polynomial, false);
         }
 
-        void make_groebner_basis() {
+        /*
+         * The critical pairs are kept in a queue ordered by the selection strategy, the pairs of
+         * the least degree are reduced first and nonzero remainders are appended to the basis,
+         * the pairs are updated by the Gebauer-Moller criteria. The elements of a computed basis
+         * stay installed, so after add and += only the pairs with the new elements are processed.
+         */
+        void make_groebner_basis(GroebnerEngine engine = GroebnerEngine::Buchberger) {
             if (type_ != BasisType::Any) {
                 return;
             }
+            assert(((void)"only the Buchberger engine works over a ring", IsField<Field>::value || engine == GroebnerEngine::Buchberger));
+            assert(((void)"only the Buchberger engine works with multilinear monomials", !MonomialType::IS_MULTILINEAR || engine == GroebnerEngine::Buchberger));
+            stats_ = GroebnerStats();
+            stats_.engine = engine;
+            stats_.strategy = strategy_;
             type_ = BasisType::Groebner;
-            for (size_t i = 0; i < polynomials_.size(); ++i) {
-                for (size_t j = 0; j < i; ++j) {
-                    const auto intersection = get_intersection(
-                        polynomials_[i].get_major_monomial(),
-                        polynomials_[j].get_major_monomial()
-                    );
-                    if (intersection.is_empty()) {
-                        continue;
+            if (engine == GroebnerEngine::Signature) {
+                make_signature_basis();
+                install_basis();
+                return;
+            }
+            auto& state = pairs_state_;
+            state.pairs = PairQueue<Compare, MonomialType>(strategy_);
+            state.multiples = PairQueue<Compare, MonomialType>(strategy_);
+            stats_.installed = installed_;
+            for (size_t i = installed_; i < polynomials_.size(); ++i) {
+                state.sugar.push_back(polynomials_[i].get_total_degree());
+                update_pairs(state, i);
+            }
+            if (engine == GroebnerEngine::Buchberger && threads_count_ > 1) {
+                ThreadPool pool(threads_count_);
+                stats_.threads = pool.get_threads_count();
+                while (!state.pairs.empty() || !state.multiples.empty()) {
+                    if (is_multiple_next(state)) {
+                        reduce_multiple(state);
+                    } else {
+                        reduce_pairs_parallel(state, pool);
+                    }
+                }
+            } else {
+                while (!state.pairs.empty() || !state.multiples.empty()) {
+                    if (is_multiple_next(state)) {
+                        reduce_multiple(state);
+                    } else if (engine == GroebnerEngine::F4) {
+                        reduce_pairs_f4(state);
+                    } else {
+                        reduce_pair(state);
                     }
-                    auto s_polynomial = polynomials_[i] * (polynomials_[j].get_major_monomial() / intersection);
-                    s_polynomial -= polynomials_[j] * (polynomials_[i].get_major_monomial() / intersection);
-                    reduce(s_polynomial);
-                    add(s_polynomial);
                 }
             }
+            installed_ = polynomials_.size();
         }
 
         void make_minimization() {
             if (type_ == BasisType::MinimizationGroebner || type_ == BasisType::UniqueGroebner) {
                 return;
             }
+            const bool is_groebner = type_ != BasisType::Any;
             type_ = BasisType::MinimizationGroebner;
-            size_t i = 0;
-            while (i < polynomials_.size()) {
+            // Of the elements with equal major monomials the first one is kept.
+            std::vector<PolynomialType> minimal;
+            for (size_t i = 0; i < polynomials_.size(); ++i) {
                 const auto& major_monomial = polynomials_[i].get_major_monomial();
-                bool remove_needed = false;
-                for (size_t j = 0; j < polynomials_.size(); ++j) {
-                    if (i != j) {
-                        if (major_monomial.is_subset(polynomials_[j].get_major_monomial())) {
-                            remove_needed = true;
-                            break;
-                        }
-                    }
-                }
-                if (remove_needed) {
-                    std::swap(polynomials_[i], polynomials_.back());
-                    polynomials_.pop_back();
-                } else {
-                    i++;
+                const size_t divisor = divisors_.find_divisor(major_monomial, [this, i, &major_monomial] (size_t j) {
+                    return j < i || polynomials_[j].get_major_monomial() != major_monomial;
+                });
+                if (divisor == DivisibilityIndex<MonomialType>::NONE) {
+                    minimal.push_back(std::move(polynomials_[i]));
                 }
             }
+            polynomials_ = std::move(minimal);
+            update_divisors();
+            if (is_groebner) {
+                install_basis();
+            } else {
+                pairs_state_ = PairsState(strategy_);
+                installed_ = 0;
+            }
         }
 
         void make_autoreduction() {
@@ -151,19 +277,19 @@ namespace polynomial {
                 return;
             }
             type_ = BasisType::AutoreductionGroebner;
-            for (size_t i = 0; i < polynomials_.size(); ++i) {
-                auto remainder = polynomials_[i] - polynomials_[i].get_major_term();
-                polynomials_[i] = polynomials_[i].get_major_term();
-                full_reduce(remainder);
-                polynomials_[i] += remainder;
+            for (auto& polynomial : polynomials_) {
+                reduce_terms(polynomial, true);
+                if constexpr (!IsField<Field>::value) {
+                    make_primitive(polynomial);
+                }
             }
         }
 
-        void make_minimal_groebner_basis() {
+        void make_minimal_groebner_basis(GroebnerEngine engine = GroebnerEngine::Buchberger) {
             if (type_ == BasisType::UniqueGroebner) {
                 return;
             }
-            make_groebner_basis();
+            make_groebner_basis(engine);
             make_minimization();
             make_autoreduction();
             type_ = BasisType::UniqueGroebner;
@@ -171,10 +297,24 @@ namespace polynomial {
             std::sort(
                 polynomials_.begin(),
                 polynomials_.end(),
-                [cmp] (const Polynomial<Field, Compare>& left, const Polynomial<Field, Compare>& right) {
+                [cmp] (const PolynomialType& left, const PolynomialType& right) {
                     return cmp(left.get_major_monomial(), right.get_major_monomial());
                 }
             );
+            update_divisors();
+            install_basis();
+        }
+
+        /*
+         * Replaces the polynomials by the reduced Groebner basis of the same ideal computed
+         * elsewhere (for example over another ring), normalized and sorted like the result of
+         * make_minimal_groebner_basis.
+         */
+        void set_minimal_groebner_basis(std::vector<PolynomialType>&& basis) {
+            polynomials_ = std::move(basis);
+            type_ = BasisType::UniqueGroebner;
+            update_divisors();
+            install_basis();
         }
 
         friend std::ostream& operator<<(std::ostream& out, const Ideal& ideal) {
@@ -191,7 +331,7 @@ namespace polynomial {
             return out;
         }
 
-        std::vector<Polynomial<Field, Compare>> get_basis() {
+        std::vector<PolynomialType> get_basis() {
             return polynomials_;
         }
 
@@ -216,7 +356,7 @@ namespace polynomial {
                 if (polynomial.is_constant()) {
                     return true;
                 }
-                const Monomial& monomial = polynomial.get_major_monomial();
+                const MonomialType& monomial = polynomial.get_major_monomial();
                 size_t id = 0;
                 size_t count = 0;
                 for (size_t i = 0; i < monomial.size(); ++i) {
@@ -245,15 +385,367 @@ namespace polynomial {
             return result;
         }
 
-        bool contains(Polynomial<Field, Compare> polynomial) {
+        bool contains(PolynomialType polynomial) {
             make_groebner_basis();
             reduce(polynomial);
             return polynomial.is_zero();
         }
 
     private:
-        std::vector<Polynomial<Field, Compare>> polynomials_;
+        // Queued pairs, sugar degrees of the basis elements and the elements which get no more pairs.
+        struct PairsState {
+            explicit PairsState(SelectionStrategy strategy) : pairs(strategy), multiples(strategy) {}
+
+            PairQueue<Compare, MonomialType> pairs;
+            std::vector<MonomialDegreeType> sugar;
+            std::vector<bool> redundant;
+            // Pairs of the elements and the field equations, second is the variable, see reduce_multiple.
+            PairQueue<Compare, MonomialType> multiples;
+        };
+
+        /*
+         * Installs the elements of a Groebner basis without creating their pairs: the sugar of an
+         * element is its degree and it is redundant if the major monomial of another element
+         * divides its major monomial, of equal major monomials the last one is kept.
+         */
+        void install_basis() {
+            pairs_state_ = PairsState(strategy_);
+            for (size_t i = 0; i < polynomials_.size(); ++i) {
+                const auto& major_monomial = polynomials_[i].get_major_monomial();
+                const size_t divisor = divisors_.find_divisor(major_monomial, [this, i, &major_monomial] (size_t j) {
+                    return j > i || (j < i && polynomials_[j].get_major_monomial() != major_monomial);
+                });
+                pairs_state_.sugar.push_back(polynomials_[i].get_total_degree());
+                pairs_state_.redundant.push_back(divisor != DivisibilityIndex<MonomialType>::NONE);
+            }
+            installed_ = polynomials_.size();
+        }
+
+        // Appends the monic (or primitive) multiple of the polynomial, returns false if the polynomial is zero.
+        bool insert(PolynomialType polynomial) {
+            if (polynomial.is_zero()) {
+                return false;
+            }
+            if constexpr (IsField<Field>::value) {
+                const Field coefficient = polynomial.get_major_coefficient();
+                polynomial /= coefficient;
+            } else {
+                make_primitive(polynomial);
+            }
+            divisors_.insert(polynomial.get_major_monomial());
+            polynomials_.push_back(std::move(polynomial));
+            return true;
+        }
+
+        /*
+         * Gebauer-Moller installation of the index-th basis element h. A queued pair (f, g) is
+         * dropped if lm(h) divides lcm(f, g) and differs from lcm(f, h) and lcm(g, h). Of the new
+         * pairs (g, h) the ones whose lcm is a proper multiple of another lcm are dropped, of the
+         * pairs with equal lcm at most one is kept, and none if any of them has coprime major
+         * monomials (Buchberger's product criterion). Elements whose major monomial is divisible
+         * by lm(h) get no pairs with further elements.
+         */
+        void update_pairs(PairsState& state, size_t index) {
+            const auto& major_monomial = polynomials_[index].get_major_monomial();
+            const auto& sugar = state.sugar;
+            auto& redundant = state.redundant;
+            stats_.chain_criterion += state.pairs.erase_if([this, &major_monomial] (const CriticalPair<MonomialType>& pair) {
+                return pair.lcm.is_subset(major_monomial)
+                    && get_union(polynomials_[pair.first].get_major_monomial(), major_monomial) != pair.lcm
+                    && get_union(polynomials_[pair.second].get_major_monomial(), major_monomial) != pair.lcm;
+            });
+            std::vector<CriticalPair<MonomialType>> candidates;
+            std::vector<bool> is_coprime;
+            for (size_t i = 0; i < index; ++i) {
+                if (redundant[i]) {
+                    continue;
+                }
+                const auto& other_monomial = polynomials_[i].get_major_monomial();
+                auto lcm = get_union(major_monomial, other_monomial);
+                const auto lcm_degree = lcm.get_total_degree();
+                is_coprime.push_back(lcm_degree == major_monomial.get_total_degree() + other_monomial.get_total_degree());
+                const auto pair_sugar = std::max(
+                    sugar[index] + lcm_degree - major_monomial.get_total_degree(),
+                    sugar[i] + lcm_degree - other_monomial.get_total_degree()
+                );
+                candidates.push_back({index, i, std::move(lcm), pair_sugar});
+            }
+            stats_.pairs_created += candidates.size();
+            for (size_t p = 0; p < candidates.size(); ++p) {
+                if (is_coprime[p]) {
+                    ++stats_.product_criterion;
+                    continue;
+                }
+                bool is_useless = false;
+                for (size_t q = 0; q < candidates.size() && !is_useless; ++q) {
+                    if (q == p || !candidates[p].lcm.is_subset(candidates[q].lcm)) {
+                        continue;
+                    }
+                    is_useless = candidates[p].lcm != candidates[q].lcm || is_coprime[q] || q < p;
+                }
+                if (is_useless) {
+                    ++stats_.chain_criterion;
+                    continue;
+                }
+                state.pairs.push(std::move(candidates[p]));
+            }
+            redundant.push_back(false);
+            for (size_t i = 0; i < index; ++i) {
+                if (!redundant[i] && polynomials_[i].get_major_monomial().is_subset(major_monomial)) {
+                    redundant[i] = true;
+                }
+            }
+            if constexpr (MonomialType::IS_MULTILINEAR) {
+                for (size_t i = major_monomial.size(); i > 0; --i) {
+                    if (major_monomial.get_degree(i - 1) > 0) {
+                        state.multiples.push({index, i - 1, major_monomial, sugar[index] + 1});
+                    }
+                }
+            }
+        }
+
+        /*
+         * With multilinear monomials the field equations x_i^2 - x_i belong to the ideal implicitly.
+         * The S-polynomial of an element f and the field equation of a variable x_i of lm(f) is the
+         * product x_i * f, in which x_i * lm(f) = lm(f) may cancel with another product. The lcm of
+         * the pair is x_i * lm(f) with x_i squared, so lm(h) divides it only if it divides lm(f), and
+         * the pair is dropped by the chain criterion once f is redundant: the pair of h and x_i^2 - x_i
+         * is either queued or satisfies the product criterion.
+         */
+        void reduce_multiple(PairsState& state) {
+            const auto pair = state.multiples.pop();
+            if (state.redundant[pair.first]) {
+                ++stats_.chain_criterion;
+                return;
+            }
+            ++stats_.multiples_reduced;
+            std::vector<MonomialDegreeType> degree(pair.second + 1);
+            degree[pair.second] = 1;
+            auto multiple = polynomials_[pair.first] * MonomialType(std::move(degree));
+            reduce(multiple);
+            if (!insert(std::move(multiple))) {
+                ++stats_.zero_reductions;
+                return;
+            }
+            state.sugar.push_back(pair.sugar);
+            update_pairs(state, polynomials_.size() - 1);
+        }
+
+        // The lcm of a pair with a field equation has the degree of lm(f) plus one, of equal degrees the multiples go first.
+        bool is_multiple_next(const PairsState& state) const {
+            if (state.multiples.empty() || state.pairs.empty()) {
+                return !state.multiples.empty();
+            }
+            const MonomialDegreeType shift = strategy_ == SelectionStrategy::Normal ? 1 : 0;
+            return state.multiples.get_lowest_degree() + shift <= state.pairs.get_lowest_degree();
+        }
+
+        void reduce_pair(PairsState& state) {
+            const auto pair = state.pairs.pop();
+            ++stats_.pairs_reduced;
+            auto s_polynomial = get_s_polynomial(polynomials_[pair.first], polynomials_[pair.second], pair.lcm);
+            reduce(s_polynomial);
+            if (!insert(std::move(s_polynomial))) {
+                ++stats_.zero_reductions;
+                return;
+            }
+            state.sugar.push_back(pair.sugar);
+            update_pairs(state, polynomials_.size() - 1);
+        }
+
+        // The basis is read-only while the pairs are reduced, the remainders are reduced once more by the new elements.
+        void reduce_pairs_parallel(PairsState& state, ThreadPool& pool) {
+            const auto pairs = state.pairs.pop_lowest_degree();
+            std::vector<PolynomialType> remainders(pairs.size());
+            const auto context = FieldContext<Field>::get();
+            pool.parallel_for(pairs.size(), [this, &pairs, &remainders, context] (size_t i) {
+                FieldContext<Field>::set(context);
+                const auto& pair = pairs[i];
+                remainders[i] = get_s_polynomial(polynomials_[pair.first], polynomials_[pair.second], pair.lcm);
+                reduce(remainders[i]);
+            });
+            stats_.pairs_reduced += pairs.size();
+            for (size_t i = 0; i < pairs.size(); ++i) {
+                reduce(remainders[i]);
+                if (!insert(std::move(remainders[i]))) {
+                    ++stats_.zero_reductions;
+                    continue;
+                }
+                state.sugar.push_back(pairs[i].sugar);
+                update_pairs(state, polynomials_.size() - 1);
+            }
+        }
+
+        void reduce_pairs_f4(PairsState& state) {
+            const auto pairs = state.pairs.pop_lowest_degree();
+            MacaulayMatrix<PolynomialType> matrix;
+            MonomialDegreeType sugar = 0;
+            for (const auto& pair : pairs) {
+                const auto& first = polynomials_[pair.first];
+                const auto& second = polynomials_[pair.second];
+                matrix.add_row(first, pair.lcm / first.get_major_monomial());
+                matrix.add_row(second, pair.lcm / second.get_major_monomial());
+                sugar = std::max(sugar, pair.sugar);
+            }
+            matrix.preprocess([this] (const MonomialType& monomial) {
+                return find_reducer(monomial);
+            });
+            auto rows = matrix.reduce();
+            stats_.pairs_reduced += pairs.size();
+            stats_.zero_reductions += matrix.get_zero_rows_count();
+            ++stats_.matrices;
+            for (auto& row : rows) {
+                insert(std::move(row));
+                state.sugar.push_back(sugar);
+                update_pairs(state, polynomials_.size() - 1);
+            }
+        }
+
+        void make_signature_basis() {
+            SignatureBasis<PolynomialType> basis(polynomials_);
+            basis.compute();
+            polynomials_ = basis.release();
+            update_divisors();
+            stats_.pairs_created = basis.get_pairs_count();
+            stats_.pairs_reduced = basis.get_reductions_count();
+            stats_.zero_reductions = basis.get_zero_reductions_count();
+            stats_.avoided_reductions = basis.get_avoided_reductions_count();
+        }
+
+        // The first basis element whose major monomial divides the monomial.
+        const PolynomialType* find_reducer(const MonomialType& monomial) const {
+            const size_t reducer = divisors_.find_divisor(monomial);
+            return reducer == DivisibilityIndex<MonomialType>::NONE ? nullptr : &polynomials_[reducer];
+        }
+
+        void update_divisors() {
+            divisors_.clear();
+            for (const auto& polynomial : polynomials_) {
+                divisors_.insert(polynomial.get_major_monomial());
+            }
+        }
+
+        /*
+         * Reduces the terms of the polynomial by the basis, all but the major one if skip_major.
+         * Over a ring the reduced terms are multiplied by the same factors as the bucket.
+         */
+        void reduce_terms(PolynomialType& polynomial, bool skip_major) const {
+            Geobucket<PolynomialType> bucket(std::move(polynomial));
+            std::vector<std::pair<MonomialType, Field>> remainder;
+            if (skip_major && !bucket.is_zero()) {
+                remainder.emplace_back(bucket.get_major_monomial(), bucket.get_major_coefficient());
+                bucket.pop_major();
+            }
+            size_t steps = 0;
+            while (!bucket.is_zero()) {
+                const auto& major_monomial = bucket.get_major_monomial();
+                const PolynomialType* reducer = find_reducer(major_monomial);
+                if (reducer == nullptr) {
+                    remainder.emplace_back(major_monomial, bucket.get_major_coefficient());
+                    bucket.pop_major();
+                    continue;
+                }
+                const Field factor = reduce_major(bucket, *reducer);
+                if constexpr (!IsField<Field>::value) {
+                    if (!factor.is_one()) {
+                        for (auto& term : remainder) {
+                            term.second *= factor;
+                        }
+                    }
+                    if (++steps % CONTENT_REMOVAL_PERIOD == 0) {
+                        auto current = bucket.release();
+                        Field content = get_content(current);
+                        for (const auto& term : remainder) {
+                            content = gcd(content, term.second);
+                        }
+                        if (!content.is_zero() && !content.is_one()) {
+                            current /= content;
+                            for (auto& term : remainder) {
+                                term.second /= content;
+                            }
+                        }
+                        bucket = Geobucket<PolynomialType>(std::move(current));
+                    }
+                }
+            }
+            polynomial = PolynomialType();
+            for (auto term = remainder.rbegin(); term != remainder.rend(); ++term) {
+                polynomial.push_major_term(term->first, term->second);
+            }
+        }
+
+        /*
+         * Cancels the major term of the bucket by the reducer, returns the factor of the bucket.
+         * Over a field the reducer is monic and the factor is one. Over a ring the bucket is first
+         * multiplied by lc(reducer) / g, where g = gcd(lc(bucket), lc(reducer)).
+         */
+        static Field reduce_major(Geobucket<PolynomialType>& bucket, const PolynomialType& reducer) {
+            const auto coefficient = bucket.get_major_coefficient();
+            const auto multiplier = bucket.get_major_monomial() / reducer.get_major_monomial();
+            bucket.pop_major();
+            if constexpr (IsField<Field>::value) {
+                bucket.subtract_multiple(reducer, multiplier, coefficient, true);
+                return Field(1);
+            } else {
+                const Field divisor = gcd(coefficient, reducer.get_major_coefficient());
+                const Field factor = reducer.get_major_coefficient() / divisor;
+                bucket.multiply(factor);
+                bucket.subtract_multiple(reducer, multiplier, coefficient / divisor, true);
+                return factor;
+            }
+        }
+
+        /*
+         * S-polynomial of two basis elements, lcm is the lcm of their major monomials. Over a ring
+         * the elements are multiplied by the cofactors of the gcd of their major coefficients.
+         */
+        static PolynomialType get_s_polynomial(const PolynomialType& first, const PolynomialType& second, const MonomialType& lcm) {
+            Field first_factor(1);
+            Field second_factor(1);
+            if constexpr (!IsField<Field>::value) {
+                const Field divisor = gcd(first.get_major_coefficient(), second.get_major_coefficient());
+                first_factor = second.get_major_coefficient() / divisor;
+                second_factor = first.get_major_coefficient() / divisor;
+            }
+            PolynomialType result;
+            result.subtract_multiple(second, lcm / second.get_major_monomial(), second_factor, true);
+            result.subtract_multiple(first, lcm / first.get_major_monomial(), Field() - first_factor, true);
+            return result;
+        }
+
+        // The gcd of the coefficients, it is positive for a nonzero polynomial and zero for zero.
+        static Field get_content(const PolynomialType& polynomial) {
+            Field result;
+            for (const auto& term : polynomial) {
+                result = gcd(result, term.second);
+                if (result.is_one()) {
+                    break;
+                }
+            }
+            return result;
+        }
+
+        // Divides the polynomial by its content, so that the major coefficient becomes positive.
+        static void make_primitive(PolynomialType& polynomial) {
+            Field content = get_content(polynomial);
+            if (polynomial.get_major_coefficient().is_negative()) {
+                content = Field() - content;
+            }
+            if (!content.is_one()) {
+                polynomial /= content;
+            }
+        }
+
+        std::vector<PolynomialType> polynomials_;
+        // Major monomials of polynomials_ in the same order.
+        DivisibilityIndex<MonomialType> divisors_;
+        // The first installed_ elements form a Groebner basis, all their pairs are processed.
+        PairsState pairs_state_{SelectionStrategy::Normal};
+        size_t installed_ = 0;
         BasisType type_ = BasisType::Any;
+        SelectionStrategy strategy_ = SelectionStrategy::Normal;
+        size_t threads_count_ = 1;
+        GroebnerStats stats_;
     };
 }
 
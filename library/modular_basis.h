@@ -0,0 +1,339 @@
+/*
+ * boost library should be installed to use this class
+ */
+
+#ifndef GROEBNER_BASIS_MODULAR_BASIS_H
+#define GROEBNER_BASIS_MODULAR_BASIS_H
+
+#include "../fields/dynamic_modular.h"
+#include "../fields/dynamic_modular64.h"
+#include "../fields/rational.h"
+#include "ideal.h"
+#include "thread_pool.h"
+
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    using IntegerType = math::IntegerType;
+
+    // The primes are taken downwards from 2^31, so that 2p - 2 fits into ModularValueType.
+    constexpr math::ModularValueType MODULAR_BASIS_PRIMES_LIMIT = 1u << 31u;
+    // The primes for DynamicModular64 are taken downwards from 2^63, as its Montgomery form requires.
+    constexpr math::ModularValueType64 MODULAR_BASIS_PRIMES_LIMIT64 = math::ModularValueType64(1) << 63u;
+    constexpr size_t MODULAR_BASIS_MAX_PRIMES = 256;
+
+    // The prime fields which can be used for the images of the multi-modular algorithm.
+    template <class ModularField>
+    struct ModularFieldTraits;
+
+    template <>
+    struct ModularFieldTraits<math::DynamicModular> {
+        using ValueType = math::ModularValueType;
+        using ContextType = math::ModularContext;
+
+        static constexpr ValueType PRIMES_LIMIT = MODULAR_BASIS_PRIMES_LIMIT;
+
+        static ValueType get_previous_prime(ValueType value) {
+            return math::get_previous_prime(value);
+        }
+    };
+
+    template <>
+    struct ModularFieldTraits<math::DynamicModular64> {
+        using ValueType = math::ModularValueType64;
+        using ContextType = math::ModularContext64;
+
+        static constexpr ValueType PRIMES_LIMIT = MODULAR_BASIS_PRIMES_LIMIT64;
+
+        static ValueType get_previous_prime(ValueType value) {
+            return math::get_previous_prime64(value);
+        }
+    };
+
+    /*
+     * Rational reconstruction: finds numerator / denominator equal to the value modulo the modulus
+     * with |numerator| and denominator not greater than sqrt(modulus / 2), such a fraction is unique.
+     */
+    bool reconstruct_rational(const IntegerType& value, const IntegerType& modulus, IntegerType& numerator, IntegerType& denominator) {
+        const IntegerType bound = boost::multiprecision::sqrt(IntegerType(modulus / 2));
+        IntegerType previous_remainder = modulus;
+        IntegerType remainder = value;
+        IntegerType previous_coefficient = 0;
+        IntegerType coefficient = 1;
+        while (remainder > bound) {
+            const IntegerType quotient = previous_remainder / remainder;
+            previous_remainder -= quotient * remainder;
+            std::swap(previous_remainder, remainder);
+            previous_coefficient -= quotient * coefficient;
+            std::swap(previous_coefficient, coefficient);
+        }
+        if (boost::multiprecision::abs(coefficient) > bound || boost::multiprecision::gcd(remainder, coefficient) != 1) {
+            return false;
+        }
+        if (coefficient < 0) {
+            remainder = -remainder;
+            coefficient = -coefficient;
+        }
+        numerator = std::move(remainder);
+        denominator = std::move(coefficient);
+        return true;
+    }
+
+    /*
+     * Multi-modular algorithm for the reduced Groebner basis over the rationals. The reduced
+     * bases modulo the primes below the limit of the field (DynamicModular or DynamicModular64) are
+     * computed in parallel, every thread with the context of its prime. The 64-bit primes give twice
+     * as many bits of the coefficients per image, so about half as many images are needed. The bases of the
+     * most frequent shape (the major monomials) are lifted by the Chinese remainder theorem and
+     * rational reconstruction. The lifted basis is accepted if it agrees with the basis modulo
+     * one more prime of the same shape, if all its S-polynomials reduce to zero over the rationals
+     * and if it contains the generators. The last check that the basis lies in the ideal of the
+     * generators is probabilistic: it fails only if all the used primes are unlucky.
+     */
+    template <class Compare, template <class, class> class Terms = MapTerms, class ModularField = math::DynamicModular>
+    class ModularBasis {
+    public:
+        using PolynomialType = Polynomial<math::Rational, Compare, Terms>;
+        using IdealType = Ideal<math::Rational, Compare, Terms>;
+
+        explicit ModularBasis(std::vector<PolynomialType>&& generators) : generators_(std::move(generators)) {}
+
+        // Returns false if the primes are exhausted without a verified basis.
+        bool compute(size_t threads_count = 1, GroebnerEngine engine = GroebnerEngine::Buchberger) {
+            ThreadPool pool(threads_count);
+            std::vector<ModularImage> images;
+            while (primes_.size() < MODULAR_BASIS_MAX_PRIMES) {
+                const size_t computed = primes_.size();
+                const size_t count = std::min(pool.get_threads_count(), MODULAR_BASIS_MAX_PRIMES - computed);
+                for (size_t i = 0; i < count; ++i) {
+                    primes_.push_back(Traits::get_previous_prime(primes_.empty() ? Traits::PRIMES_LIMIT : primes_.back()));
+                }
+                images.resize(primes_.size());
+                pool.parallel_for(count, [this, &images, computed, engine] (size_t i) {
+                    images[computed + i] = get_image(primes_[computed + i], engine);
+                });
+                if (lift(images)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        IdealType release() {
+            return std::move(result_);
+        }
+
+        size_t get_primes_count() const {
+            return primes_.size();
+        }
+
+        size_t get_bad_primes_count() const {
+            return bad_primes_count_;
+        }
+
+    private:
+        using Traits = ModularFieldTraits<ModularField>;
+        using ValueType = typename Traits::ValueType;
+
+        // Reduced basis modulo a prime, the terms of the polynomials are in the increasing order.
+        struct ModularImage {
+            bool is_bad = false;
+            std::vector<Monomial> shape;
+            std::vector<std::vector<std::pair<Monomial, ValueType>>> polynomials;
+        };
+
+        using ModularPolynomialType = Polynomial<ModularField, Compare, Terms>;
+
+        static ValueType get_residue(const IntegerType& value, ValueType prime) {
+            IntegerType residue = value % prime;
+            if (residue < 0) {
+                residue += prime;
+            }
+            return residue.convert_to<ValueType>();
+        }
+
+        static ValueType multiply(ValueType first, ValueType second, ValueType prime) {
+            return static_cast<ValueType>(static_cast<math::ModularValueType128>(first) * second % prime);
+        }
+
+        // The prime of the context is bad if it divides a denominator of the coefficients.
+        static bool reduce_modulo(const PolynomialType& polynomial, ModularPolynomialType& result) {
+            using ModularType = ModularField;
+            const ValueType prime = ModularType::get_modulo();
+            for (const auto& term : polynomial) {
+                const auto denominator = get_residue(term.second.get_denominator(), prime);
+                if (denominator == 0) {
+                    return false;
+                }
+                const auto numerator = get_residue(term.second.get_numerator(), prime);
+                result.add(term.first, ModularType(numerator) / ModularType(denominator));
+            }
+            return true;
+        }
+
+        ModularImage get_image(ValueType prime, GroebnerEngine engine) const {
+            const typename Traits::ContextType context(prime);
+            typename ModularField::ContextGuard guard(context);
+            ModularImage result;
+            std::vector<ModularPolynomialType> polynomials(generators_.size());
+            for (size_t i = 0; i < generators_.size(); ++i) {
+                if (!reduce_modulo(generators_[i], polynomials[i])) {
+                    result.is_bad = true;
+                    return result;
+                }
+            }
+            Ideal<ModularField, Compare, Terms> ideal(std::move(polynomials));
+            ideal.make_minimal_groebner_basis(engine);
+            for (const auto& polynomial : ideal.get_basis()) {
+                result.shape.push_back(polynomial.get_major_monomial());
+                result.polynomials.emplace_back();
+                for (const auto& term : polynomial) {
+                    result.polynomials.back().emplace_back(term.first, term.second.get_value());
+                }
+            }
+            return result;
+        }
+
+        // Lifts the images of the most frequent shape but the last one, the last one checks the result.
+        bool lift(const std::vector<ModularImage>& images) {
+            const size_t count = images.size();
+            std::vector<size_t> group;
+            bad_primes_count_ = 0;
+            for (size_t i = 0; i < count; ++i) {
+                if (images[i].is_bad) {
+                    ++bad_primes_count_;
+                    continue;
+                }
+                std::vector<size_t> current;
+                for (size_t j = i; j < count; ++j) {
+                    if (!images[j].is_bad && images[j].shape == images[i].shape) {
+                        current.push_back(j);
+                    }
+                }
+                if (current.size() > group.size()) {
+                    group = std::move(current);
+                }
+            }
+            if (group.size() < 2) {
+                return false;
+            }
+            const size_t check = group.back();
+            group.pop_back();
+            std::vector<std::map<Monomial, IntegerType, Compare>> values(images[check].shape.size());
+            IntegerType modulus = 1;
+            for (size_t index : group) {
+                const ValueType prime = primes_[index];
+                const ValueType inverse = get_inverse(get_residue(modulus, prime), prime);
+                for (size_t i = 0; i < values.size(); ++i) {
+                    std::map<Monomial, ValueType, Compare> residues(images[index].polynomials[i].begin(), images[index].polynomials[i].end());
+                    for (auto& value : values[i]) {
+                        const auto residue = residues.find(value.first);
+                        combine(value.second, modulus, inverse, residue == residues.end() ? 0 : residue->second, prime);
+                    }
+                    for (const auto& residue : residues) {
+                        auto value = values[i].emplace(residue.first, 0);
+                        if (value.second) {
+                            combine(value.first->second, modulus, inverse, residue.second, prime);
+                        }
+                    }
+                }
+                modulus *= prime;
+            }
+            std::vector<PolynomialType> basis;
+            IntegerType numerator;
+            IntegerType denominator;
+            for (const auto& polynomial : values) {
+                basis.emplace_back();
+                for (const auto& value : polynomial) {
+                    if (!reconstruct_rational(value.second, modulus, numerator, denominator)) {
+                        return false;
+                    }
+                    math::RationalType coefficient(numerator);
+                    coefficient /= denominator;
+                    basis.back().push_major_term(value.first, coefficient);
+                }
+            }
+            return is_image(basis, images[check], primes_[check]) && verify(std::move(basis));
+        }
+
+        static ValueType get_inverse(ValueType value, ValueType prime) {
+            ValueType result = 1;
+            for (ValueType degree = prime - 2; degree > 0; degree >>= 1u) {
+                if (degree & 1u) {
+                    result = multiply(result, value, prime);
+                }
+                value = multiply(value, value, prime);
+            }
+            return result;
+        }
+
+        // The value modulo the modulus becomes the value modulo modulus * prime with the given residue.
+        static void combine(IntegerType& value, const IntegerType& modulus, ValueType inverse, ValueType residue, ValueType prime) {
+            const ValueType current = get_residue(value, prime);
+            const ValueType difference = residue >= current ? residue - current : residue + (prime - current);
+            value += modulus * multiply(difference, inverse, prime);
+        }
+
+        static bool is_image(const std::vector<PolynomialType>& basis, const ModularImage& image, ValueType prime) {
+            for (size_t i = 0; i < basis.size(); ++i) {
+                if (basis[i].get_terms_count() != image.polynomials[i].size()) {
+                    return false;
+                }
+                size_t j = 0;
+                for (const auto& term : basis[i]) {
+                    const auto& expected = image.polynomials[i][j++];
+                    const auto numerator = get_residue(term.second.get_numerator(), prime);
+                    const auto denominator = get_residue(term.second.get_denominator(), prime);
+                    if (term.first != expected.first || denominator == 0 ||
+                        multiply(expected.second, denominator, prime) != numerator) {
+                        return false;
+                    }
+                }
+            }
+            return true;
+        }
+
+        bool verify(std::vector<PolynomialType>&& basis) {
+            auto copy = basis;
+            IdealType ideal(std::move(copy));
+            ideal.make_minimal_groebner_basis();
+            if (ideal.get_basis() != basis) {
+                return false;
+            }
+            for (const auto& generator : generators_) {
+                if (!ideal.contains(generator)) {
+                    return false;
+                }
+            }
+            result_ = std::move(ideal);
+            return true;
+        }
+
+        std::vector<PolynomialType> generators_;
+        std::vector<ValueType> primes_;
+        IdealType result_;
+        size_t bad_primes_count_ = 0;
+    };
+
+    /*
+     * Replaces the ideal over the rationals by its reduced Groebner basis computed by the
+     * multi-modular algorithm, falls back to make_minimal_groebner_basis if the primes are
+     * exhausted. Returns true if the multi-modular algorithm succeeded. The field of the images is
+     * given by the first template argument.
+     */
+    template <class ModularField = math::DynamicModular, class Compare, template <class, class> class Terms>
+    bool make_modular_groebner_basis(Ideal<math::Rational, Compare, Terms>& ideal, size_t threads_count = 1, GroebnerEngine engine = GroebnerEngine::Buchberger) {
+        ModularBasis<Compare, Terms, ModularField> basis(ideal.get_basis());
+        if (!basis.compute(threads_count, engine)) {
+            ideal.make_minimal_groebner_basis(engine);
+            return false;
+        }
+        ideal = basis.release();
+        return true;
+    }
+}
+
+#endif
@@ -3,25 +3,130 @@
 
 #include <cassert>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <initializer_list>
+#include <limits>
+#include <string>
 #include <vector>
 #include <iostream>
 
 namespace polynomial {
 
     using MonomialDegreeType = uint32_t;
+    using MonomialPackedDegreeType = uint16_t;
+    using MonomialMaskType = uint64_t;
+
+    /*
+     * Monomials with at most MONOMIAL_PACKED_CAPACITY variables and exponents not greater than
+     * MONOMIAL_PACKED_LIMIT are stored inline in 16-bit cells, all other monomials are promoted
+     * to a heap array of MonomialDegreeType. The representation is canonical: a monomial is
+     * promoted if and only if it doesn't fit into the packed storage.
+     */
+    constexpr size_t MONOMIAL_PACKED_CAPACITY = 16;
+    constexpr MonomialDegreeType MONOMIAL_PACKED_LIMIT = std::numeric_limits<MonomialPackedDegreeType>::max();
+
+    /*
+     * Divisibility mask: variable i owns MONOMIAL_MASK_BITS bits starting at
+     * (i % MONOMIAL_MASK_VARIABLES) * MONOMIAL_MASK_BITS, the k-th of them is set if the degree of
+     * the variable is at least 2^k. If a monomial divides another one, its mask is a submask of the
+     * other mask, so most non-divisible pairs are rejected without looking at the exponents.
+     */
+    constexpr size_t MONOMIAL_MASK_BITS = 4;
+    constexpr size_t MONOMIAL_MASK_VARIABLES = 16;
+
+    MonomialMaskType get_degree_mask(size_t num, MonomialDegreeType degree) {
+        MonomialMaskType bits = 0;
+        for (size_t k = 0; k < MONOMIAL_MASK_BITS && degree >= (MonomialDegreeType(1) << k); ++k) {
+            bits |= MonomialMaskType(1) << k;
+        }
+        return bits << (num % MONOMIAL_MASK_VARIABLES * MONOMIAL_MASK_BITS);
+    }
+
+    /*
+     * Stream manipulator of the variable names: after out << VariableNames{&names} the variable i
+     * is printed to out as names[i] while i < names.size(), the other variables and the variables
+     * of the streams without names are printed as x_i. The names should outlive their use by the
+     * stream, out << VariableNames{} restores x_i.
+     */
+    struct VariableNames {
+        const std::deque<std::string>* names = nullptr;
+    };
+
+    int get_variable_names_index() {
+        static const int index = std::ios_base::xalloc();
+        return index;
+    }
+
+    std::ostream& operator<<(std::ostream& out, VariableNames names) {
+        out.pword(get_variable_names_index()) = const_cast<std::deque<std::string>*>(names.names);
+        return out;
+    }
+
+    void print_variable(std::ostream& out, size_t num) {
+        const auto* names = static_cast<const std::deque<std::string>*>(out.pword(get_variable_names_index()));
+        if (names != nullptr && num < names->size()) {
+            out << (*names)[num];
+        } else {
+            out << "x_" << num;
+        }
+    }
 
     class Monomial {
     public:
+        // The product by a monomial preserves the order of the monomials, see BooleanMonomial.
+        static constexpr bool IS_MULTILINEAR = false;
+
         Monomial() = default;
 
-        Monomial(std::vector<MonomialDegreeType>&& degree) : degree_(degree) {
-            while (!degree_.empty() && degree_.back() == 0) {
-                degree_.pop_back();
+        Monomial(std::vector<MonomialDegreeType>&& degree) {
+            assign(degree.data(), degree.size());
+        }
+
+        Monomial(std::initializer_list<MonomialDegreeType> degree) {
+            assign(degree.begin(), degree.size());
+        }
+
+        Monomial(const Monomial& other) {
+            copy_from(other);
+        }
+
+        Monomial(Monomial&& other) noexcept {
+            move_from(other);
+        }
+
+        Monomial& operator=(const Monomial& other) {
+            if (this != &other) {
+                release();
+                copy_from(other);
+            }
+            return *this;
+        }
+
+        Monomial& operator=(Monomial&& other) noexcept {
+            if (this != &other) {
+                release();
+                move_from(other);
             }
+            return *this;
+        }
+
+        ~Monomial() {
+            release();
         }
 
         friend bool operator==(const Monomial& first, const Monomial& second) {
-            return first.degree_ == second.degree_;
+            if (first.mask_ != second.mask_ || first.total_degree_ != second.total_degree_) {
+                return false;
+            }
+            if (first.size_ != second.size_ || first.is_packed_ != second.is_packed_) {
+                return false;
+            }
+            if (first.is_packed_) {
+                return std::memcmp(first.packed_, second.packed_, first.size_ * sizeof(MonomialPackedDegreeType)) == 0;
+            }
+            return std::equal(first.wide_, first.wide_ + first.size_, second.wide_);
         }
 
         friend bool operator!=(const Monomial& first, const Monomial& second) {
@@ -29,62 +134,101 @@ namespace polynomial {
         }
 
         friend bool operator<(const Monomial& first, const Monomial& second) {
-            return first.degree_ < second.degree_;
+            const size_t common = std::min(first.size_, second.size_);
+            if (first.is_packed_ && second.is_packed_) {
+                for (size_t i = 0; i < common; ++i) {
+                    if (first.packed_[i] != second.packed_[i]) {
+                        return first.packed_[i] < second.packed_[i];
+                    }
+                }
+            } else {
+                for (size_t i = 0; i < common; ++i) {
+                    if (first.at(i) != second.at(i)) {
+                        return first.at(i) < second.at(i);
+                    }
+                }
+            }
+            return first.size_ < second.size_;
         }
 
         friend Monomial operator*(const Monomial& first, const Monomial& second) {
-            std::vector<MonomialDegreeType> result(std::max(first.size(), second.size()), 0);
-            for (size_t i = 0; i < first.size(); ++i) {
-                result[i] = first.degree_[i];
-            }
-            for (size_t i = 0; i < second.size(); ++i) {
-                result[i] += second.degree_[i];
-            }
-            return std::move(result);
+            Monomial result(first);
+            result *= second;
+            return result;
         }
 
-        Monomial operator*=(const Monomial& other) {
-            if (size() < other.size()) {
-                degree_.resize(other.size(), 0);
+        Monomial& operator*=(const Monomial& other) {
+            const size_t result_size = std::max(size_, other.size_);
+            if (is_packed_ && other.is_packed_) {
+                MonomialDegreeType overflow = 0;
+                for (size_t i = size_; i < result_size; ++i) {
+                    packed_[i] = 0;
+                }
+                for (size_t i = 0; i < other.size_; ++i) {
+                    overflow |= static_cast<MonomialDegreeType>(packed_[i]) + other.packed_[i];
+                }
+                if (overflow <= MONOMIAL_PACKED_LIMIT) {
+                    for (size_t i = 0; i < other.size_; ++i) {
+                        packed_[i] += other.packed_[i];
+                    }
+                    size_ = result_size;
+                    update_cache();
+                    return *this;
+                }
             }
-            for (size_t i = 0; i < other.size(); ++i) {
-                degree_[i] += other.degree_[i];
+            MonomialDegreeType* degree = new MonomialDegreeType[result_size];
+            for (size_t i = 0; i < result_size; ++i) {
+                degree[i] = get_degree(i) + other.get_degree(i);
             }
+            release();
+            is_packed_ = false;
+            wide_ = degree;
+            size_ = result_size;
+            update_cache();
             return *this;
         }
 
         friend Monomial operator/(const Monomial& first, const Monomial& second) {
-            assert(((void)"divider should be a subset of dividend", first.size() >= second.size()));
-            std::vector<MonomialDegreeType> result(first.degree_.begin(), first.degree_.end());
-            for (size_t i = 0; i < second.size(); ++i) {
-                assert(((void)"divider should be a subset of dividend", first.degree_[i] >= second.degree_[i]));
-                result[i] -= second.degree_[i];
-            }
-            return std::move(result);
+            Monomial result(first);
+            result /= second;
+            return result;
         }
 
-        Monomial operator/=(const Monomial& other) {
+        Monomial& operator/=(const Monomial& other) {
             assert(((void)"divider should be a subset of dividend", size() >= other.size()));
-            for (size_t i = 0; i < other.size(); ++i) {
-                assert(((void)"divider should be a subset of dividend", degree_[i] >= other.degree_[i]));
-                degree_[i] -= other.degree_[i];
-            }
-            while (!degree_.empty() && degree_.back() == 0) {
-                degree_.pop_back();
+            if (is_packed_) {
+                for (size_t i = 0; i < other.size_; ++i) {
+                    assert(((void)"divider should be a subset of dividend", packed_[i] >= other.get_degree(i)));
+                    packed_[i] -= other.get_degree(i);
+                }
+            } else {
+                for (size_t i = 0; i < other.size_; ++i) {
+                    assert(((void)"divider should be a subset of dividend", wide_[i] >= other.get_degree(i)));
+                    wide_[i] -= other.get_degree(i);
+                }
             }
+            normalize();
             return *this;
         }
 
         size_t size() const {
-            return degree_.size();
+            return size_;
         }
 
         bool is_subset(const Monomial& other) const {
-            if (size() < other.size()) {
+            if (size_ < other.size_ || total_degree_ < other.total_degree_ || (other.mask_ & ~mask_) != 0) {
                 return false;
             }
-            for (size_t i = 0; i < other.size(); ++i) {
-                if (degree_[i] < other.degree_[i]) {
+            if (is_packed_ && other.is_packed_) {
+                for (size_t i = 0; i < other.size_; ++i) {
+                    if (packed_[i] < other.packed_[i]) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            for (size_t i = 0; i < other.size_; ++i) {
+                if (at(i) < other.at(i)) {
                     return false;
                 }
             }
@@ -92,14 +236,26 @@ namespace polynomial {
         }
 
         bool is_empty() const {
-            return degree_.empty();
+            return size_ == 0;
+        }
+
+        bool is_packed() const {
+            return is_packed_;
+        }
+
+        MonomialDegreeType get_total_degree() const {
+            return total_degree_;
+        }
+
+        MonomialMaskType get_mask() const {
+            return mask_;
         }
 
         MonomialDegreeType get_degree(size_t num) const {
-            if (num >= size()) {
+            if (num >= size_) {
                 return 0;
             }
-            return degree_[num];
+            return at(num);
         }
 
         friend std::ostream& operator<<(std::ostream& out, const Monomial& element) {
@@ -108,10 +264,11 @@ namespace polynomial {
                 return out;
             }
             for (size_t i = 0; i < element.size(); ++i) {
-                if (element.degree_[i] > 0) {
-                    out << "x_" << i;
-                    if (element.degree_[i] > 1) {
-                        out << "^" << element.degree_[i];
+                const auto degree = element.at(i);
+                if (degree > 0) {
+                    print_variable(out, i);
+                    if (degree > 1) {
+                        out << "^" << degree;
                     }
                     if (i + 1 != element.size()) {
                         out << "*";
@@ -121,17 +278,154 @@ namespace polynomial {
             return out;
         }
 
+        friend Monomial get_intersection(const Monomial& first, const Monomial& second);
+
+        friend Monomial get_union(const Monomial& first, const Monomial& second);
+
     private:
-        std::vector<MonomialDegreeType> degree_;
+        MonomialDegreeType at(size_t num) const {
+            return is_packed_ ? packed_[num] : wide_[num];
+        }
+
+        template <class Iterator>
+        void assign(Iterator degree, size_t size) {
+            while (size > 0 && degree[size - 1] == 0) {
+                --size;
+            }
+            bool fits = size <= MONOMIAL_PACKED_CAPACITY;
+            for (size_t i = 0; fits && i < size; ++i) {
+                fits = degree[i] <= MONOMIAL_PACKED_LIMIT;
+            }
+            size_ = size;
+            is_packed_ = fits;
+            if (fits) {
+                for (size_t i = 0; i < size; ++i) {
+                    packed_[i] = degree[i];
+                }
+            } else {
+                wide_ = new MonomialDegreeType[size];
+                std::copy(degree, degree + size, wide_);
+            }
+            update_cache();
+        }
+
+        void update_cache() {
+            total_degree_ = 0;
+            mask_ = 0;
+            for (size_t i = 0; i < size_; ++i) {
+                const auto degree = at(i);
+                total_degree_ += degree;
+                mask_ |= get_degree_mask(i, degree);
+            }
+        }
+
+        void normalize() {
+            while (size_ > 0 && at(size_ - 1) == 0) {
+                --size_;
+            }
+            if (!is_packed_) {
+                MonomialDegreeType* degree = wide_;
+                assign(degree, size_);
+                delete[] degree;
+            } else {
+                update_cache();
+            }
+        }
+
+        void copy_from(const Monomial& other) {
+            mask_ = other.mask_;
+            total_degree_ = other.total_degree_;
+            size_ = other.size_;
+            is_packed_ = other.is_packed_;
+            if (is_packed_) {
+                std::memcpy(packed_, other.packed_, size_ * sizeof(MonomialPackedDegreeType));
+            } else {
+                wide_ = new MonomialDegreeType[size_];
+                std::copy(other.wide_, other.wide_ + size_, wide_);
+            }
+        }
+
+        void move_from(Monomial& other) {
+            mask_ = other.mask_;
+            total_degree_ = other.total_degree_;
+            size_ = other.size_;
+            is_packed_ = other.is_packed_;
+            if (is_packed_) {
+                std::memcpy(packed_, other.packed_, size_ * sizeof(MonomialPackedDegreeType));
+            } else {
+                wide_ = other.wide_;
+                other.is_packed_ = true;
+                other.size_ = 0;
+                other.mask_ = 0;
+                other.total_degree_ = 0;
+            }
+        }
+
+        void release() {
+            if (!is_packed_) {
+                delete[] wide_;
+                is_packed_ = true;
+                size_ = 0;
+                mask_ = 0;
+                total_degree_ = 0;
+            }
+        }
+
+        MonomialMaskType mask_ = 0;
+        MonomialDegreeType total_degree_ = 0;
+        uint32_t size_ = 0;
+        bool is_packed_ = true;
+        union {
+            MonomialPackedDegreeType packed_[MONOMIAL_PACKED_CAPACITY];
+            MonomialDegreeType* wide_;
+        };
     };
 
     Monomial get_intersection(const Monomial& first, const Monomial& second) {
-        std::vector<MonomialDegreeType> degree(std::min(first.size(), second.size()));
-        for (size_t i = 0; i < degree.size(); ++i) {
-            degree[i] = std::min(first.get_degree(i), second.get_degree(i));
+        Monomial result;
+        if ((first.mask_ & second.mask_) == 0) {
+            return result;
+        }
+        const size_t size = std::min(first.size(), second.size());
+        if (first.is_packed_ || second.is_packed_) {
+            for (size_t i = 0; i < size; ++i) {
+                result.packed_[i] = std::min(first.at(i), second.at(i));
+            }
+            result.size_ = size;
+            result.normalize();
+            return result;
+        }
+        std::vector<MonomialDegreeType> degree(size);
+        for (size_t i = 0; i < size; ++i) {
+            degree[i] = std::min(first.at(i), second.at(i));
+        }
+        return std::move(degree);
+    }
+
+    // The least common multiple, the counterpart of get_intersection.
+    Monomial get_union(const Monomial& first, const Monomial& second) {
+        const size_t size = std::max(first.size(), second.size());
+        if (first.is_packed_ && second.is_packed_) {
+            Monomial result;
+            for (size_t i = 0; i < size; ++i) {
+                result.packed_[i] = std::max(first.get_degree(i), second.get_degree(i));
+            }
+            result.size_ = size;
+            result.update_cache();
+            return result;
+        }
+        std::vector<MonomialDegreeType> degree(size);
+        for (size_t i = 0; i < size; ++i) {
+            degree[i] = std::max(first.get_degree(i), second.get_degree(i));
         }
         return std::move(degree);
     }
+
+    // Monomials of the polynomials over the field, the fields with other monomials specialize it.
+    template <class Field>
+    struct FieldMonomial {
+        using Type = Monomial;
+    };
 }
 
 #endif
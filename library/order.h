@@ -0,0 +1,182 @@
+#ifndef GROEBNER_BASIS_ORDER_H
+#define GROEBNER_BASIS_ORDER_H
+
+#include "boolean_monomial.h"
+#include "monomial.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace polynomial {
+
+    /*
+     * Term orders for the Compare parameter of Polynomial and Ideal. As for std::less<Monomial>,
+     * x_0 > x_1 > ... > x_n. Besides operator() every order provides a three-way comparison of
+     * the monomials restricted to the variables [from, to), which is used to build block orders.
+     * The orders compare Monomial and BooleanMonomial alike.
+     */
+    constexpr size_t ORDER_ALL_VARIABLES = std::numeric_limits<size_t>::max();
+
+    using OrderWeightType = uint64_t;
+
+    template <class MonomialType>
+    OrderWeightType get_range_degree(const MonomialType& monomial, size_t from, size_t to) {
+        if (from == 0 && to >= monomial.size()) {
+            return monomial.get_total_degree();
+        }
+        OrderWeightType result = 0;
+        for (size_t i = from; i < std::min(to, monomial.size()); ++i) {
+            result += monomial.get_degree(i);
+        }
+        return result;
+    }
+
+    class LexOrder {
+    public:
+        template <class MonomialType>
+        static int compare(const MonomialType& first, const MonomialType& second, size_t from, size_t to) {
+            to = std::min(to, std::max(first.size(), second.size()));
+            for (size_t i = from; i < to; ++i) {
+                const auto first_degree = first.get_degree(i);
+                const auto second_degree = second.get_degree(i);
+                if (first_degree != second_degree) {
+                    return first_degree < second_degree ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        template <class MonomialType>
+        bool operator()(const MonomialType& first, const MonomialType& second) const {
+            return first < second;
+        }
+    };
+
+    class DeglexOrder {
+    public:
+        template <class MonomialType>
+        static int compare(const MonomialType& first, const MonomialType& second, size_t from, size_t to) {
+            const auto first_degree = get_range_degree(first, from, to);
+            const auto second_degree = get_range_degree(second, from, to);
+            if (first_degree != second_degree) {
+                return first_degree < second_degree ? -1 : 1;
+            }
+            return LexOrder::compare(first, second, from, to);
+        }
+
+        template <class MonomialType>
+        bool operator()(const MonomialType& first, const MonomialType& second) const {
+            if (first.get_total_degree() != second.get_total_degree()) {
+                return first.get_total_degree() < second.get_total_degree();
+            }
+            return first < second;
+        }
+    };
+
+    class GrevlexOrder {
+    public:
+        template <class MonomialType>
+        static int compare(const MonomialType& first, const MonomialType& second, size_t from, size_t to) {
+            const auto first_degree = get_range_degree(first, from, to);
+            const auto second_degree = get_range_degree(second, from, to);
+            if (first_degree != second_degree) {
+                return first_degree < second_degree ? -1 : 1;
+            }
+            return compare_reverse(first, second, from, to);
+        }
+
+        template <class MonomialType>
+        bool operator()(const MonomialType& first, const MonomialType& second) const {
+            if (first.get_total_degree() != second.get_total_degree()) {
+                return first.get_total_degree() < second.get_total_degree();
+            }
+            return compare_reverse(first, second, 0, ORDER_ALL_VARIABLES) < 0;
+        }
+
+    private:
+        template <class MonomialType>
+        static int compare_reverse(const MonomialType& first, const MonomialType& second, size_t from, size_t to) {
+            to = std::min(to, std::max(first.size(), second.size()));
+            for (size_t i = to; i > from; --i) {
+                const auto first_degree = first.get_degree(i - 1);
+                const auto second_degree = second.get_degree(i - 1);
+                if (first_degree != second_degree) {
+                    return first_degree > second_degree ? -1 : 1;
+                }
+            }
+            return 0;
+        }
+
+        // The boolean monomials are compared by words.
+        static int compare_reverse(const BooleanMonomial& first, const BooleanMonomial& second, size_t from, size_t to) {
+            if (from == 0 && to >= std::max(first.size(), second.size())) {
+                return first.compare_reverse(second);
+            }
+            return compare_reverse<BooleanMonomial>(first, second, from, to);
+        }
+    };
+
+    /*
+     * Compares the weighted degrees first, ties are broken by GrevlexOrder. The weights are applied
+     * to x_0, x_1, ... in order, variables without an explicit weight have weight 1.
+     */
+    template <OrderWeightType... weights>
+    class WeightedOrder {
+    public:
+        template <class MonomialType>
+        static int compare(const MonomialType& first, const MonomialType& second, size_t from, size_t to) {
+            const auto first_weight = get_weight(first, from, to);
+            const auto second_weight = get_weight(second, from, to);
+            if (first_weight != second_weight) {
+                return first_weight < second_weight ? -1 : 1;
+            }
+            return GrevlexOrder::compare(first, second, from, to);
+        }
+
+        template <class MonomialType>
+        bool operator()(const MonomialType& first, const MonomialType& second) const {
+            return compare(first, second, 0, ORDER_ALL_VARIABLES) < 0;
+        }
+
+    private:
+        template <class MonomialType>
+        static OrderWeightType get_weight(const MonomialType& monomial, size_t from, size_t to) {
+            static constexpr OrderWeightType order_weights[] = {weights..., 1};
+            constexpr size_t weights_count = sizeof...(weights);
+            to = std::min(to, monomial.size());
+            OrderWeightType result = 0;
+            for (size_t i = from; i < to; ++i) {
+                const OrderWeightType weight = (i < weights_count ? order_weights[i] : 1);
+                result += weight * monomial.get_degree(i);
+            }
+            return result;
+        }
+    };
+
+    /*
+     * Elimination order: the variables x_0, ..., x_{block_size - 1} are compared by FirstOrder,
+     * ties are broken by comparing the remaining variables by SecondOrder. Block orders can be
+     * nested to get more than two blocks.
+     */
+    template <size_t block_size, class FirstOrder = GrevlexOrder, class SecondOrder = GrevlexOrder>
+    class BlockOrder {
+    public:
+        template <class MonomialType>
+        static int compare(const MonomialType& first, const MonomialType& second, size_t from, size_t to) {
+            const size_t middle = std::min(to, from + block_size);
+            const int result = FirstOrder::compare(first, second, from, middle);
+            if (result != 0 || middle == to) {
+                return result;
+            }
+            return SecondOrder::compare(first, second, middle, to);
+        }
+
+        template <class MonomialType>
+        bool operator()(const MonomialType& first, const MonomialType& second) const {
+            return compare(first, second, 0, ORDER_ALL_VARIABLES) < 0;
+        }
+    };
+}
+
+#endif
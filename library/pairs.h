@@ -0,0 +1,129 @@
+#ifndef GROEBNER_BASIS_PAIRS_H
+#define GROEBNER_BASIS_PAIRS_H
+
+#include "monomial.h"
+
+#include <cassert>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    /*
+     * Selection strategies of the critical pair queue. Normal takes the pair with the least degree
+     * of the lcm of the major monomials, Sugar takes the pair with the least sugar degree, which
+     * is the degree the S-polynomial would have if the input was homogenized. Both strategies are
+     * the same for homogeneous ideals, Sugar is much better for non-homogeneous ones.
+     */
+    enum class SelectionStrategy {
+        Normal,
+        Sugar
+    };
+
+    std::ostream& operator<<(std::ostream& out, SelectionStrategy strategy) {
+        out << (strategy == SelectionStrategy::Sugar ? "sugar" : "normal");
+        return out;
+    }
+
+    // Pair of basis elements, second < first, lcm is the lcm of their major monomials.
+    template <class MonomialType>
+    struct CriticalPair {
+        size_t first;
+        size_t second;
+        MonomialType lcm;
+        MonomialDegreeType sugar;
+    };
+
+    /*
+     * Critical pairs ordered by the selection strategy, ties are broken by the degree of lcm, by
+     * Compare and by the indices, so the pairs are always processed in the same order.
+     */
+    template <class Compare, class MonomialType = Monomial>
+    class PairQueue {
+    public:
+        using PairType = CriticalPair<MonomialType>;
+
+        explicit PairQueue(SelectionStrategy strategy) : pairs_(PairOrder{strategy}) {}
+
+        bool empty() const {
+            return pairs_.empty();
+        }
+
+        size_t size() const {
+            return pairs_.size();
+        }
+
+        void push(PairType&& pair) {
+            pairs_.insert(std::move(pair));
+        }
+
+        PairType pop() {
+            assert(((void)"the queue is empty", !pairs_.empty()));
+            auto node = pairs_.extract(pairs_.begin());
+            return std::move(node.value());
+        }
+
+        // The least degree of the pairs with respect to the selection strategy.
+        MonomialDegreeType get_lowest_degree() const {
+            assert(((void)"the queue is empty", !pairs_.empty()));
+            return pairs_.key_comp().get_degree(*pairs_.begin());
+        }
+
+        // Pops all pairs of the least degree with respect to the selection strategy.
+        std::vector<PairType> pop_lowest_degree() {
+            assert(((void)"the queue is empty", !pairs_.empty()));
+            const auto degree = pairs_.key_comp().get_degree(*pairs_.begin());
+            std::vector<PairType> result;
+            while (!pairs_.empty() && pairs_.key_comp().get_degree(*pairs_.begin()) == degree) {
+                result.push_back(pop());
+            }
+            return result;
+        }
+
+        // Removes the pairs satisfying the predicate, returns the number of removed pairs.
+        template <class Predicate>
+        size_t erase_if(Predicate predicate) {
+            size_t result = 0;
+            for (auto pair = pairs_.begin(); pair != pairs_.end();) {
+                if (predicate(*pair)) {
+                    pair = pairs_.erase(pair);
+                    ++result;
+                } else {
+                    ++pair;
+                }
+            }
+            return result;
+        }
+
+    private:
+        struct PairOrder {
+            SelectionStrategy strategy;
+
+            MonomialDegreeType get_degree(const PairType& pair) const {
+                return strategy == SelectionStrategy::Sugar ? pair.sugar : pair.lcm.get_total_degree();
+            }
+
+            bool operator()(const PairType& left, const PairType& right) const {
+                if (get_degree(left) != get_degree(right)) {
+                    return get_degree(left) < get_degree(right);
+                }
+                if (left.lcm.get_total_degree() != right.lcm.get_total_degree()) {
+                    return left.lcm.get_total_degree() < right.lcm.get_total_degree();
+                }
+                Compare cmp;
+                if (cmp(left.lcm, right.lcm)) {
+                    return true;
+                }
+                if (cmp(right.lcm, left.lcm)) {
+                    return false;
+                }
+                return std::make_pair(left.first, left.second) < std::make_pair(right.first, right.second);
+            }
+        };
+
+        std::set<PairType, PairOrder> pairs_;
+    };
+}
+
+#endif
@@ -1,37 +1,132 @@
 #ifndef GROEBNER_BASIS_POLYNOMIAL_H
 #define GROEBNER_BASIS_POLYNOMIAL_H
 
+#include "geobucket.h"
 #include "monomial.h"
+#include "order.h"
+#include "terms.h"
 
 #include <algorithm>
 #include <functional>
 #include <map>
 #include <initializer_list>
 #include <iostream>
+#include <thread>
+#include <type_traits>
 #include <utility>
+#include <vector>
 
 namespace polynomial {
 
-    template<class Field, class Compare = std::less<Monomial>>
+    // Products with at least this many pairs of terms are computed on all hardware threads.
+    constexpr size_t POLYNOMIAL_PARALLEL_THRESHOLD = 1 << 16;
+
+    /*
+     * Context of the current thread needed by the field arithmetic. Fields with such a context
+     * (DynamicModular) define ContextType, get_context and set_context, the worker threads take
+     * the context of the thread which started them.
+     */
+    template <class Field, class = void>
+    struct FieldContext {
+        using Type = bool;
+
+        static Type get() {
+            return false;
+        }
+
+        static void set(Type) {}
+    };
+
+    template <class Field>
+    struct FieldContext<Field, std::void_t<typename Field::ContextType>> {
+        using Type = typename Field::ContextType;
+
+        static Type get() {
+            return Field::get_context();
+        }
+
+        static void set(Type context) {
+            Field::set_context(context);
+        }
+    };
+
+    /*
+     * Sum of products of field elements and the row operations of the linear algebra over the
+     * field. Fields with delayed reduction (Modular, DynamicModular) define AccumulatorType, which
+     * reduces the sum only when get is called and has vectorized row operations.
+     */
+    template <class Field, class = void>
+    struct FieldAccumulator {
+        class Type {
+        public:
+            Type() = default;
+
+            Type(const Field& value) : value_(value) {}
+
+            void add_product(const Field& first, const Field& second) {
+                value_ += first * second;
+            }
+
+            Field get() const {
+                return value_;
+            }
+
+            // sums[columns[i]] += factor * values[i] for the distinct columns.
+            static void add_scaled_row(Type* sums, const uint32_t* columns, const Field* values, size_t size, const Field& factor) {
+                for (size_t i = 0; i < size; ++i) {
+                    sums[columns[i]].add_product(factor, values[i]);
+                }
+            }
+
+            static void scale_row(Field* values, size_t size, const Field& factor) {
+                for (size_t i = 0; i < size; ++i) {
+                    values[i] *= factor;
+                }
+            }
+
+        private:
+            Field value_;
+        };
+    };
+
+    template <class Field>
+    struct FieldAccumulator<Field, std::void_t<typename Field::AccumulatorType>> {
+        using Type = typename Field::AccumulatorType;
+    };
+
+    /*
+     * Coefficient rings which are not fields (Integer) define IS_FIELD as false. The ideals over
+     * them keep the polynomials primitive instead of monic and reduce them fraction-free.
+     */
+    template <class Field, class = void>
+    struct IsField : std::true_type {};
+
+    template <class Field>
+    struct IsField<Field, std::void_t<decltype(Field::IS_FIELD)>> : std::bool_constant<Field::IS_FIELD> {};
+
+    template<class Field, class Compare = std::less<typename FieldMonomial<Field>::Type>, template <class, class> class Terms = MapTerms>
     class Polynomial {
     public:
+        using FieldType = Field;
+        using CompareType = Compare;
+        using TermsType = Terms<Field, Compare>;
+        using MonomialType = typename TermsType::MonomialType;
+        using const_iterator = typename TermsType::const_iterator;
+
         Polynomial() = default;
 
-        Polynomial(const Monomial& monomial, const Field& coefficient) {
+        Polynomial(const MonomialType& monomial, const Field& coefficient) {
             if (!coefficient.is_zero()) {
-                terms_[monomial] = coefficient;
+                terms_.push_back(monomial, coefficient);
             }
         }
 
-        Polynomial(std::map<Monomial, Field, Compare>&& terms) : terms_(terms) {}
+        Polynomial(std::map<MonomialType, Field, Compare>&& terms) : terms_(std::move(terms)) {}
 
-        Polynomial(std::initializer_list<std::pair<Monomial, Field>> terms) {
+        Polynomial(std::initializer_list<std::pair<MonomialType, Field>> terms) {
             for (const auto& term : terms) {
                 if (!term.second.is_zero()) {
-                    terms_[term.first] += term.second;
-                    if (terms_[term.first].is_zero()) {
-                        terms_.erase(term.first);
-                    }
+                    terms_.add(term.first, term.second);
                 }
             }
         }
@@ -45,164 +140,181 @@ namespace polynomial {
         }
 
         friend Polynomial operator+(const Polynomial& first, const Polynomial& second) {
-            std::map<Monomial, Field, Compare> result(first.terms_);
-            for (const auto& term : second.terms_) {
-                result[term.first] += term.second;
-                if (result[term.first].is_zero()) {
-                    result.erase(term.first);
-                }
-            }
-            return std::move(result);
+            Polynomial result(first);
+            result.terms_.add(second.terms_);
+            return result;
         }
 
-        Polynomial operator+=(const Polynomial& other) {
-            for (const auto& term : other.terms_) {
-                terms_[term.first] += term.second;
-                if (terms_[term.first].is_zero()) {
-                    terms_.erase(term.first);
-                }
-            }
+        Polynomial& operator+=(const Polynomial& other) {
+            terms_.add(other.terms_);
             return *this;
         }
 
         friend Polynomial operator-(const Polynomial& first, const Polynomial& second) {
-            std::map<Monomial, Field, Compare> result(first.terms_);
-            for (const auto& term : second.terms_) {
-                result[term.first] -= term.second;
-                if (result[term.first].is_zero()) {
-                    result.erase(term.first);
-                }
-            }
-            return std::move(result);
+            Polynomial result(first);
+            result.terms_.subtract(second.terms_);
+            return result;
         }
 
-        Polynomial operator-=(const Polynomial& other) {
-            for (const auto& term : other.terms_) {
-                terms_[term.first] -= term.second;
-                if (terms_[term.first].is_zero()) {
-                    terms_.erase(term.first);
-                }
-            }
+        Polynomial& operator-=(const Polynomial& other) {
+            terms_.subtract(other.terms_);
             return *this;
         }
 
         friend Polynomial operator*(const Polynomial& polynomial, const Field& coefficient) {
-            if (coefficient.is_zero()) {
-                return Polynomial<Field, Compare>();
-            }
-            std::map<Monomial, Field, Compare> result(polynomial.terms_);
-            for (auto& term : result) {
-                term.second *= coefficient;
-            }
-            return std::move(result);
+            Polynomial result(polynomial);
+            result *= coefficient;
+            return result;
         }
 
-        Polynomial operator*=(const Field& coefficient) {
+        Polynomial& operator*=(const Field& coefficient) {
             if (coefficient.is_zero()) {
                 terms_.clear();
             } else {
-                for (auto& term : terms_) {
-                    term.second *= coefficient;
-                }
+                terms_.multiply(coefficient);
             }
             return *this;
         }
 
         friend Polynomial operator/(const Polynomial& polynomial, const Field& coefficient) {
-            assert(((void)"divizion by zero", !coefficient.is_zero()));
-            std::map<Monomial, Field, Compare> result(polynomial.terms_);
-            for (auto& term : result) {
-                term.second /= coefficient;
-            }
-            return std::move(result);
+            Polynomial result(polynomial);
+            result /= coefficient;
+            return result;
         }
 
-        Polynomial operator/=(const Field& coefficient) {
+        Polynomial& operator/=(const Field& coefficient) {
             assert(((void)"divizion by zero", !coefficient.is_zero()));
-            for (auto& term : terms_) {
-                term.second /= coefficient;
-            }
+            terms_.divide(coefficient);
             return *this;
         }
 
-        friend Polynomial operator/(const Polynomial& polynomial, const Monomial& monomial) {
-            Polynomial<Field, Compare> result;
+        friend Polynomial operator/(const Polynomial& polynomial, const MonomialType& monomial) {
+            Polynomial result;
             for (const auto& term : polynomial.terms_) {
                 if (term.first.is_subset(monomial)) {
-                    result.add(term.first / monomial, term.second);
+                    result.terms_.push_back(term.first / monomial, term.second);
                 }
             }
             return result;
         }
 
-        friend Polynomial operator*(const Polynomial& polynomial, const Monomial& monomial) {
-            std::map<Monomial, Field, Compare> result;
-            for (const auto& term : polynomial.terms_) {
-                result[term.first * monomial] = term.second;
-            }
-            return std::move(result);
+        friend Polynomial operator*(const Polynomial& polynomial, const MonomialType& monomial) {
+            Polynomial result(polynomial);
+            result *= monomial;
+            return result;
         }
 
-        Polynomial operator*=(const Monomial& monomial) {
-            *this = *this * monomial;
+        Polynomial& operator*=(const MonomialType& monomial) {
+            terms_.multiply(monomial);
             return *this;
         }
 
         friend Polynomial operator*(const Polynomial& first, const Polynomial& second) {
-            std::map<Monomial, Field, Compare> result;
-            for (const auto& first_term : first.terms_) {
-                for (const auto& second_term : second.terms_) {
-                    const auto multiply = first_term.first * second_term.first;
-                    result[multiply] += first_term.second * second_term.second;
-                    if (result[multiply].is_zero()) {
-                        result.erase(multiply);
-                    }
+            size_t threads_count = 1;
+            if (first.get_terms_count() * second.get_terms_count() >= POLYNOMIAL_PARALLEL_THRESHOLD) {
+                threads_count = std::max(1u, std::thread::hardware_concurrency());
+            }
+            return multiply(first, second, threads_count);
+        }
+
+        /*
+         * Heap-based (Johnson) multiplication: the terms of the shorter operand are merged against
+         * the longer one through a heap of at most one entry per term, so the product terms are
+         * produced in order and appended without lookups. With several threads the shorter operand
+         * is split into chunks, which are multiplied concurrently and then summed.
+         */
+        static Polynomial multiply(const Polynomial& first, const Polynomial& second, size_t threads_count) {
+            if (first.is_zero() || second.is_zero()) {
+                return Polynomial();
+            }
+            // The products of multilinear monomials come out of order, so the terms are summed in a geobucket.
+            if constexpr (MonomialType::IS_MULTILINEAR) {
+                Geobucket<Polynomial> bucket;
+                for (const auto& term : first) {
+                    bucket.subtract_multiple(second, term.first, Field() - term.second);
                 }
+                return bucket.release();
+            }
+            const bool is_first_outer = first.get_terms_count() <= second.get_terms_count();
+            const auto outer = get_term_references(is_first_outer ? first : second);
+            const auto inner = get_term_references(is_first_outer ? second : first);
+            threads_count = std::min(threads_count, outer.size());
+            if (threads_count <= 1) {
+                return multiply_terms(outer.data(), outer.data() + outer.size(), inner);
             }
-            return std::move(result);
+            std::vector<Polynomial> parts(threads_count);
+            std::vector<std::thread> workers;
+            const auto context = FieldContext<Field>::get();
+            for (size_t i = 0; i < threads_count; ++i) {
+                const auto from = outer.data() + outer.size() * i / threads_count;
+                const auto to = outer.data() + outer.size() * (i + 1) / threads_count;
+                workers.emplace_back([&parts, &inner, from, to, i, context] {
+                    FieldContext<Field>::set(context);
+                    parts[i] = multiply_terms(from, to, inner);
+                });
+            }
+            for (auto& worker : workers) {
+                worker.join();
+            }
+            for (size_t i = 1; i < threads_count; ++i) {
+                parts[0] += parts[i];
+            }
+            return std::move(parts[0]);
         }
 
-        Polynomial operator*=(const Polynomial& other) {
+        Polynomial& operator*=(const Polynomial& other) {
             *this = *this * other;
             return *this;
         }
 
         void reduce(Polynomial& polynomial) const {
             assert(((void)"the reducing polynomial is a zero polynomial", !is_zero()));
-            while (!polynomial.is_zero()) {
-                auto major_monomial = polynomial.get_major_monomial();
+            Geobucket<Polynomial> bucket(std::move(polynomial));
+            while (!bucket.is_zero()) {
+                const auto& major_monomial = bucket.get_major_monomial();
                 if (!major_monomial.is_subset(get_major_monomial())) {
                     break;
                 }
-                const auto coefficient = polynomial.get_major_coefficient() / get_major_coefficient();
-                major_monomial /= get_major_monomial();
-                for (const auto& term : terms_) {
-                    polynomial.subtract(term.first * major_monomial, term.second * coefficient);
-                }
+                const auto coefficient = bucket.get_major_coefficient() / get_major_coefficient();
+                const auto multiplier = major_monomial / get_major_monomial();
+                bucket.pop_major();
+                bucket.subtract_multiple(*this, multiplier, coefficient, true);
             }
+            polynomial = bucket.release();
         }
 
         void full_reduce(Polynomial& polynomial) const {
             assert(((void)"the reducing polynomial is a zero polynomial", !is_zero()));
-            while (!polynomial.is_zero()) {
-                auto div = polynomial / get_major_monomial();
-                if (div.is_zero()) {
-                    break;
+            Geobucket<Polynomial> bucket(std::move(polynomial));
+            std::vector<std::pair<MonomialType, Field>> remainder;
+            while (!bucket.is_zero()) {
+                const auto& major_monomial = bucket.get_major_monomial();
+                if (!major_monomial.is_subset(get_major_monomial())) {
+                    remainder.emplace_back(major_monomial, bucket.get_major_coefficient());
+                    bucket.pop_major();
+                    continue;
                 }
-                div /= get_major_coefficient();
-                polynomial -= (*this) * div;
+                const auto coefficient = bucket.get_major_coefficient() / get_major_coefficient();
+                const auto multiplier = major_monomial / get_major_monomial();
+                bucket.pop_major();
+                bucket.subtract_multiple(*this, multiplier, coefficient, true);
+            }
+            polynomial = Polynomial();
+            for (auto term = remainder.rbegin(); term != remainder.rend(); ++term) {
+                polynomial.push_major_term(term->first, term->second);
             }
         }
 
         friend std::ostream& operator<<(std::ostream& out, const Polynomial& polynomial) {
-            for (auto monomial_iterator = polynomial.terms_.rbegin();
-                 monomial_iterator != polynomial.terms_.rend();
-                 ++monomial_iterator) {
-                if (monomial_iterator != polynomial.terms_.rbegin()) {
+            for (auto term_iterator = polynomial.terms_.rbegin();
+                 term_iterator != polynomial.terms_.rend();
+                 ++term_iterator) {
+                if (term_iterator != polynomial.terms_.rbegin()) {
                     out << "+";
                 }
-                const auto& monomial = monomial_iterator->first;
-                const auto& coefficient = monomial_iterator->second;
+                const auto& term = *term_iterator;
+                const auto& monomial = term.first;
+                const auto& coefficient = term.second;
                 if (monomial.is_empty()) {
                     out << coefficient;
                 } else {
@@ -215,6 +327,14 @@ namespace polynomial {
             return out;
         }
 
+        const_iterator begin() const {
+            return terms_.begin();
+        }
+
+        const_iterator end() const {
+            return terms_.end();
+        }
+
         bool is_zero() const {
             return terms_.empty();
         }
@@ -226,7 +346,7 @@ namespace polynomial {
             if (terms_.size() > 1u) {
                 return false;
             }
-            return terms_.begin()->first.is_empty();
+            return terms_.get_major_monomial().is_empty();
         }
 
         size_t size() const {
@@ -237,37 +357,127 @@ namespace polynomial {
             return result;
         }
 
-        Monomial get_major_monomial() const {
+        MonomialDegreeType get_total_degree() const {
+            MonomialDegreeType result = 0;
+            for (const auto& term : terms_) {
+                result = std::max(result, term.first.get_total_degree());
+            }
+            return result;
+        }
+
+        size_t get_terms_count() const {
+            return terms_.size();
+        }
+
+        const MonomialType& get_major_monomial() const {
             assert(((void)"the polynomial is a zero polynomial", !is_zero()));
-            return terms_.rbegin()->first;
+            return terms_.get_major_monomial();
         }
 
-        Field get_major_coefficient() const {
+        const Field& get_major_coefficient() const {
             assert(((void)"the polynomial is a zero polynomial", !is_zero()));
-            return terms_.rbegin()->second;
+            return terms_.get_major_coefficient();
         }
 
         Polynomial get_major_term() const {
             assert(((void)"the polynomial is a zero polynomial", !is_zero()));
-            return {*terms_.rbegin()};
+            return Polynomial(get_major_monomial(), get_major_coefficient());
         }
 
-        void add(const Monomial& monomial, const Field& coefficient) {
-            terms_[monomial] += coefficient;
-            if (terms_[monomial].is_zero()) {
-                terms_.erase(monomial);
+        void add(const MonomialType& monomial, const Field& coefficient) {
+            if (!coefficient.is_zero()) {
+                terms_.add(monomial, coefficient);
             }
         }
 
-        void subtract(const Monomial& monomial, const Field& coefficient) {
-            terms_[monomial] -= coefficient;
-            if (terms_[monomial].is_zero()) {
-                terms_.erase(monomial);
+        void subtract(const MonomialType& monomial, const Field& coefficient) {
+            if (!coefficient.is_zero()) {
+                terms_.subtract(monomial, coefficient);
+            }
+        }
+
+        /*
+         * Fused kernel: subtracts coefficient * monomial * other in place without building the
+         * product. If skip_major is set, the major term of other is left out, which is used when the
+         * major term of the result is known to cancel.
+         */
+        void subtract_multiple(const Polynomial& other, const MonomialType& monomial, const Field& coefficient, bool skip_major = false) {
+            if (!coefficient.is_zero()) {
+                terms_.subtract_multiple(other.terms_, monomial, coefficient, skip_major);
+            }
+        }
+
+        // Appends a term greater than all terms of the polynomial.
+        void push_major_term(const MonomialType& monomial, const Field& coefficient) {
+            assert(((void)"the term should be the major one", is_zero() || Compare()(get_major_monomial(), monomial)));
+            if (!coefficient.is_zero()) {
+                terms_.push_back(monomial, coefficient);
             }
         }
 
     private:
-        std::map<Monomial, Field, Compare> terms_;
+        using TermReference = std::pair<const MonomialType*, const Field*>;
+
+        static std::vector<TermReference> get_term_references(const Polynomial& polynomial) {
+            std::vector<TermReference> result;
+            result.reserve(polynomial.get_terms_count());
+            for (const auto& term : polynomial.terms_) {
+                result.emplace_back(&term.first, &term.second);
+            }
+            return result;
+        }
+
+        // Every outer term has at most one product in the heap, so the heap keeps only row indices.
+        static Polynomial multiply_terms(const TermReference* from, const TermReference* to, const std::vector<TermReference>& inner) {
+            const size_t outer_size = to - from;
+            std::vector<MonomialType> products(outer_size);
+            std::vector<size_t> positions(outer_size, 0);
+            Compare cmp;
+            auto is_greater = [&cmp, &products] (size_t first, size_t second) {
+                return cmp(products[second], products[first]);
+            };
+            std::vector<size_t> heap;
+            heap.reserve(outer_size);
+            products[0] = *from[0].first * *inner[0].first;
+            heap.push_back(0);
+            Polynomial result;
+            MonomialType monomial;
+            Field coefficient;
+            bool has_term = false;
+            while (!heap.empty()) {
+                std::pop_heap(heap.begin(), heap.end(), is_greater);
+                const size_t row = heap.back();
+                heap.pop_back();
+                if (has_term && products[row] != monomial) {
+                    result.push_major_term(monomial, coefficient);
+                    has_term = false;
+                }
+                if (!has_term) {
+                    monomial = products[row];
+                    coefficient = Field();
+                    has_term = true;
+                }
+                const size_t column = positions[row];
+                coefficient += *from[row].second * *inner[column].second;
+                if (column == 0 && row + 1 < outer_size) {
+                    products[row + 1] = *from[row + 1].first * *inner[0].first;
+                    heap.push_back(row + 1);
+                    std::push_heap(heap.begin(), heap.end(), is_greater);
+                }
+                if (column + 1 < inner.size()) {
+                    positions[row] = column + 1;
+                    products[row] = *from[row].first * *inner[column + 1].first;
+                    heap.push_back(row);
+                    std::push_heap(heap.begin(), heap.end(), is_greater);
+                }
+            }
+            if (has_term) {
+                result.push_major_term(monomial, coefficient);
+            }
+            return result;
+        }
+
+        TermsType terms_;
     };
 }
 
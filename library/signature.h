@@ -0,0 +1,255 @@
+#ifndef GROEBNER_BASIS_SIGNATURE_H
+#define GROEBNER_BASIS_SIGNATURE_H
+
+#include "geobucket.h"
+#include "monomial.h"
+
+#include <limits>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    /*
+     * Signature of a polynomial p = sum h_i * f_i of the ideal: the greatest term monomial * e_index
+     * of the representation, ordered position over term, that is by index and then by Compare.
+     */
+    template <class MonomialType>
+    struct Signature {
+        size_t index;
+        MonomialType monomial;
+    };
+
+    /*
+     * Signature-based Groebner basis algorithm in the style of GVW and F5. The S-pairs (J-pairs)
+     * are processed by increasing signature and reduced only by regular reductions, which don't
+     * increase the signature. A pair is skipped without reduction if its signature is divisible by
+     * the signature of a known syzygy (a reduction to zero or a Koszul syzygy, the F5 criterion),
+     * if its signature was already processed or if it is covered by a multiple of another element
+     * with the same signature and a less major monomial (the rewrite criterion). A reduced
+     * polynomial is dropped if its major term is reducible by an element of the same signature.
+     */
+    template <class PolynomialType>
+    class SignatureBasis {
+    public:
+        using FieldType = typename PolynomialType::FieldType;
+        using CompareType = typename PolynomialType::CompareType;
+        using MonomialType = typename PolynomialType::MonomialType;
+        using SignatureType = Signature<MonomialType>;
+
+        // The generators should be nonzero and monic.
+        explicit SignatureBasis(const std::vector<PolynomialType>& generators) : generators_(generators), syzygies_(generators.size()) {}
+
+        void compute() {
+            for (size_t i = 0; i < generators_.size(); ++i) {
+                pairs_.insert({{i, MonomialType()}, GENERATOR, MonomialType()});
+            }
+            while (!pairs_.empty()) {
+                auto node = pairs_.extract(pairs_.begin());
+                process(node.value());
+            }
+        }
+
+        std::vector<PolynomialType> release() {
+            return std::move(polynomials_);
+        }
+
+        size_t get_pairs_count() const {
+            return pairs_count_;
+        }
+
+        size_t get_reductions_count() const {
+            return reductions_count_;
+        }
+
+        size_t get_zero_reductions_count() const {
+            return zero_reductions_count_;
+        }
+
+        size_t get_avoided_reductions_count() const {
+            return avoided_reductions_count_;
+        }
+
+    private:
+        static constexpr size_t GENERATOR = std::numeric_limits<size_t>::max();
+
+        // The polynomial multiplier * element (or the generator) with the given signature.
+        struct SignaturePair {
+            SignatureType signature;
+            size_t element;
+            MonomialType multiplier;
+        };
+
+        static int compare(const SignatureType& first, const SignatureType& second) {
+            if (first.index != second.index) {
+                return first.index < second.index ? -1 : 1;
+            }
+            CompareType cmp;
+            if (cmp(first.monomial, second.monomial)) {
+                return -1;
+            }
+            return cmp(second.monomial, first.monomial) ? 1 : 0;
+        }
+
+        struct PairOrder {
+            bool operator()(const SignaturePair& left, const SignaturePair& right) const {
+                const int result = compare(left.signature, right.signature);
+                if (result != 0) {
+                    return result < 0;
+                }
+                return left.element < right.element;
+            }
+        };
+
+        void process(const SignaturePair& pair) {
+            const bool is_repeated = has_processed_ && compare(pair.signature, processed_) == 0;
+            if (is_repeated || is_syzygy(pair.signature) || (pair.element != GENERATOR && is_covered(pair))) {
+                ++avoided_reductions_count_;
+                return;
+            }
+            has_processed_ = true;
+            processed_ = pair.signature;
+            ++reductions_count_;
+            const auto& signature = pair.signature;
+            PolynomialType polynomial;
+            if (pair.element == GENERATOR) {
+                polynomial = generators_[signature.index];
+            } else {
+                polynomial = polynomials_[pair.element] * pair.multiplier;
+            }
+            Geobucket<PolynomialType> bucket(std::move(polynomial));
+            while (!bucket.is_zero()) {
+                const size_t reducer = find_reducer(bucket.get_major_monomial(), signature);
+                if (reducer == GENERATOR) {
+                    break;
+                }
+                const auto coefficient = bucket.get_major_coefficient();
+                const auto multiplier = bucket.get_major_monomial() / polynomials_[reducer].get_major_monomial();
+                bucket.pop_major();
+                bucket.subtract_multiple(polynomials_[reducer], multiplier, coefficient, true);
+            }
+            polynomial = bucket.release();
+            if (polynomial.is_zero()) {
+                ++zero_reductions_count_;
+                syzygies_[signature.index].push_back(signature.monomial);
+                return;
+            }
+            if (is_singular_reducible(polynomial.get_major_monomial(), signature)) {
+                return;
+            }
+            const FieldType coefficient = polynomial.get_major_coefficient();
+            polynomial /= coefficient;
+            polynomials_.push_back(std::move(polynomial));
+            signatures_.push_back(signature);
+            add_pairs(polynomials_.size() - 1);
+        }
+
+        // The F5 criterion covers the Koszul syzygies lm(g) * e_index of the elements g of smaller index.
+        bool is_syzygy(const SignatureType& signature) const {
+            for (const auto& monomial : syzygies_[signature.index]) {
+                if (signature.monomial.is_subset(monomial)) {
+                    return true;
+                }
+            }
+            for (size_t i = 0; i < polynomials_.size(); ++i) {
+                if (signatures_[i].index < signature.index && signature.monomial.is_subset(polynomials_[i].get_major_monomial())) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // The pair is covered if a multiple of another element has the same signature and a less major monomial.
+        bool is_covered(const SignaturePair& pair) const {
+            const MonomialType major_monomial = polynomials_[pair.element].get_major_monomial() * pair.multiplier;
+            for (size_t i = 0; i < polynomials_.size(); ++i) {
+                const auto& signature = signatures_[i];
+                if (signature.index != pair.signature.index || !pair.signature.monomial.is_subset(signature.monomial)) {
+                    continue;
+                }
+                MonomialType multiple = pair.signature.monomial / signature.monomial;
+                multiple *= polynomials_[i].get_major_monomial();
+                if (CompareType()(multiple, major_monomial)) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // An element g such that lm(g) divides the monomial and the signature of the multiple is less.
+        size_t find_reducer(const MonomialType& monomial, const SignatureType& signature) const {
+            for (size_t i = 0; i < polynomials_.size(); ++i) {
+                const auto& major_monomial = polynomials_[i].get_major_monomial();
+                if (!monomial.is_subset(major_monomial)) {
+                    continue;
+                }
+                if (signatures_[i].index < signature.index) {
+                    return i;
+                }
+                if (signatures_[i].index == signature.index) {
+                    MonomialType product = monomial / major_monomial;
+                    product *= signatures_[i].monomial;
+                    if (CompareType()(product, signature.monomial)) {
+                        return i;
+                    }
+                }
+            }
+            return GENERATOR;
+        }
+
+        // The major term is reducible by an element of the same signature, so the polynomial is redundant.
+        bool is_singular_reducible(const MonomialType& monomial, const SignatureType& signature) const {
+            for (size_t i = 0; i < polynomials_.size(); ++i) {
+                const auto& major_monomial = polynomials_[i].get_major_monomial();
+                if (signatures_[i].index != signature.index || !monomial.is_subset(major_monomial)) {
+                    continue;
+                }
+                MonomialType product = monomial / major_monomial;
+                product *= signatures_[i].monomial;
+                if (product == signature.monomial) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // Queues the J-pairs of the index-th element, the pair gets the greater of the two signatures.
+        void add_pairs(size_t index) {
+            const auto& major_monomial = polynomials_[index].get_major_monomial();
+            for (size_t i = 0; i < index; ++i) {
+                const auto& other_monomial = polynomials_[i].get_major_monomial();
+                const auto lcm = get_union(major_monomial, other_monomial);
+                SignatureType first{signatures_[index].index, lcm / major_monomial};
+                first.monomial *= signatures_[index].monomial;
+                SignatureType second{signatures_[i].index, lcm / other_monomial};
+                second.monomial *= signatures_[i].monomial;
+                const int result = compare(first, second);
+                if (result == 0) {
+                    continue;
+                }
+                ++pairs_count_;
+                if (result > 0) {
+                    pairs_.insert({std::move(first), index, lcm / major_monomial});
+                } else {
+                    pairs_.insert({std::move(second), i, lcm / other_monomial});
+                }
+            }
+        }
+
+        const std::vector<PolynomialType>& generators_;
+        std::vector<PolynomialType> polynomials_;
+        std::vector<SignatureType> signatures_;
+        // Monomials of the signatures of the syzygies found by reductions to zero, for every index.
+        std::vector<std::vector<MonomialType>> syzygies_;
+        std::set<SignaturePair, PairOrder> pairs_;
+        bool has_processed_ = false;
+        SignatureType processed_;
+        size_t pairs_count_ = 0;
+        size_t reductions_count_ = 0;
+        size_t zero_reductions_count_ = 0;
+        size_t avoided_reductions_count_ = 0;
+    };
+}
+
+#endif
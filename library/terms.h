@@ -0,0 +1,700 @@
+#ifndef GROEBNER_BASIS_TERMS_H
+#define GROEBNER_BASIS_TERMS_H
+
+#include "monomial.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <iterator>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace polynomial {
+
+    /*
+     * Term storages for the Terms parameter of Polynomial. A storage keeps the terms with nonzero
+     * coefficients sorted by Compare, iteration goes from the minor term to the major one and
+     * yields pairs of (monomial, coefficient). Besides sums a storage implements the fused kernel
+     * subtract_multiple(other, monomial, coefficient, skip_major), which subtracts
+     * coefficient * monomial * other in place, optionally without the major term of other.
+     */
+
+    template <class Field, class Compare>
+    class MapTerms {
+    public:
+        using MonomialType = typename FieldMonomial<Field>::Type;
+        using const_iterator = typename std::map<MonomialType, Field, Compare>::const_iterator;
+        using const_reverse_iterator = typename std::map<MonomialType, Field, Compare>::const_reverse_iterator;
+
+        MapTerms() = default;
+
+        explicit MapTerms(std::map<MonomialType, Field, Compare>&& terms) : terms_(std::move(terms)) {}
+
+        friend bool operator==(const MapTerms& first, const MapTerms& second) {
+            return first.terms_ == second.terms_;
+        }
+
+        const_iterator begin() const {
+            return terms_.begin();
+        }
+
+        const_iterator end() const {
+            return terms_.end();
+        }
+
+        const_reverse_iterator rbegin() const {
+            return terms_.rbegin();
+        }
+
+        const_reverse_iterator rend() const {
+            return terms_.rend();
+        }
+
+        bool empty() const {
+            return terms_.empty();
+        }
+
+        size_t size() const {
+            return terms_.size();
+        }
+
+        void clear() {
+            terms_.clear();
+        }
+
+        const MonomialType& get_major_monomial() const {
+            return terms_.rbegin()->first;
+        }
+
+        const Field& get_major_coefficient() const {
+            return terms_.rbegin()->second;
+        }
+
+        void push_back(const MonomialType& monomial, const Field& coefficient) {
+            terms_.emplace_hint(terms_.end(), monomial, coefficient);
+        }
+
+        void add(const MonomialType& monomial, const Field& coefficient) {
+            update(terms_.end(), monomial, coefficient, false);
+        }
+
+        void subtract(const MonomialType& monomial, const Field& coefficient) {
+            update(terms_.end(), monomial, coefficient, true);
+        }
+
+        void add(const MapTerms& other) {
+            merge(other, false, nullptr, nullptr, false);
+        }
+
+        void subtract(const MapTerms& other) {
+            merge(other, false, nullptr, nullptr, true);
+        }
+
+        void subtract_multiple(const MapTerms& other, const MonomialType& monomial, const Field& coefficient, bool skip_major) {
+            merge(other, skip_major, &monomial, &coefficient, true);
+        }
+
+        void multiply(const Field& coefficient) {
+            for (auto& term : terms_) {
+                term.second *= coefficient;
+            }
+        }
+
+        void divide(const Field& coefficient) {
+            for (auto& term : terms_) {
+                term.second /= coefficient;
+            }
+        }
+
+        void multiply(const MonomialType& monomial) {
+            if constexpr (MonomialType::IS_MULTILINEAR) {
+                MapTerms result;
+                for (const auto& term : terms_) {
+                    result.add(term.first * monomial, term.second);
+                }
+                terms_.swap(result.terms_);
+                return;
+            }
+            std::map<MonomialType, Field, Compare> result;
+            for (auto& term : terms_) {
+                result.emplace_hint(result.end(), term.first * monomial, std::move(term.second));
+            }
+            terms_.swap(result);
+        }
+
+    private:
+        using iterator = typename std::map<MonomialType, Field, Compare>::iterator;
+
+        // Adds the term with one lookup, the hint is a position not less than the monomial.
+        iterator update(iterator hint, const MonomialType& monomial, const Field& coefficient, bool is_subtraction) {
+            Compare cmp;
+            if (hint != terms_.begin()) {
+                auto previous = std::prev(hint);
+                if (cmp(previous->first, monomial)) {
+                    hint = terms_.emplace_hint(hint, monomial, is_subtraction ? Field() - coefficient : coefficient);
+                    return hint;
+                }
+                hint = terms_.lower_bound(monomial);
+            }
+            if (hint != terms_.end() && !cmp(monomial, hint->first)) {
+                if (is_subtraction) {
+                    hint->second -= coefficient;
+                } else {
+                    hint->second += coefficient;
+                }
+                if (hint->second.is_zero()) {
+                    return terms_.erase(hint);
+                }
+                return hint;
+            }
+            return terms_.emplace_hint(hint, monomial, is_subtraction ? Field() - coefficient : coefficient);
+        }
+
+        // Adds or subtracts factor * shift * other, the terms of other are visited from the major one.
+        void merge(const MapTerms& other, bool skip_major, const MonomialType* shift, const Field* factor, bool is_subtraction) {
+            if (&other == this) {
+                const MapTerms copy(other);
+                merge(copy, skip_major, shift, factor, is_subtraction);
+                return;
+            }
+            auto term = other.terms_.rbegin();
+            if (skip_major && term != other.terms_.rend()) {
+                ++term;
+            }
+            auto hint = terms_.end();
+            MonomialType shifted;
+            for (; term != other.terms_.rend(); ++term) {
+                const MonomialType* monomial = &term->first;
+                if (shift != nullptr) {
+                    shifted = term->first;
+                    shifted *= *shift;
+                    monomial = &shifted;
+                    // The products of multilinear monomials are not in order, so the hint is of no use.
+                    if constexpr (MonomialType::IS_MULTILINEAR) {
+                        hint = terms_.end();
+                    }
+                }
+                if (factor != nullptr) {
+                    hint = update(hint, *monomial, term->second * *factor, is_subtraction);
+                } else {
+                    hint = update(hint, *monomial, term->second, is_subtraction);
+                }
+            }
+        }
+
+        std::map<MonomialType, Field, Compare> terms_;
+    };
+
+    /*
+     * Terms are kept in two contiguous arrays sorted by Compare: monomials and coefficients.
+     * Sums, differences and subtract_multiple are linear merges into per-thread scratch arrays,
+     * which are swapped with the storage afterwards, so repeated merges don't allocate.
+     */
+    template <class Field, class Compare>
+    class VectorTerms {
+    public:
+        using MonomialType = typename FieldMonomial<Field>::Type;
+
+        class const_iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = std::pair<const MonomialType&, const Field&>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            const_iterator() = default;
+
+            const_iterator(const VectorTerms* terms, size_t index) : terms_(terms), index_(index) {}
+
+            reference operator*() const {
+                return {terms_->monomials_[index_], terms_->coefficients_[index_]};
+            }
+
+            const_iterator& operator++() {
+                ++index_;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result = *this;
+                ++index_;
+                return result;
+            }
+
+            const_iterator& operator--() {
+                --index_;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator result = *this;
+                --index_;
+                return result;
+            }
+
+            friend bool operator==(const const_iterator& first, const const_iterator& second) {
+                return first.index_ == second.index_;
+            }
+
+            friend bool operator!=(const const_iterator& first, const const_iterator& second) {
+                return !(first == second);
+            }
+
+        private:
+            const VectorTerms* terms_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        VectorTerms() = default;
+
+        explicit VectorTerms(std::map<MonomialType, Field, Compare>&& terms) {
+            monomials_.reserve(terms.size());
+            coefficients_.reserve(terms.size());
+            for (auto& term : terms) {
+                monomials_.push_back(term.first);
+                coefficients_.push_back(std::move(term.second));
+            }
+        }
+
+        friend bool operator==(const VectorTerms& first, const VectorTerms& second) {
+            return first.monomials_ == second.monomials_ && first.coefficients_ == second.coefficients_;
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, monomials_.size());
+        }
+
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const {
+            return const_reverse_iterator(begin());
+        }
+
+        bool empty() const {
+            return monomials_.empty();
+        }
+
+        size_t size() const {
+            return monomials_.size();
+        }
+
+        void clear() {
+            monomials_.clear();
+            coefficients_.clear();
+        }
+
+        const MonomialType& get_major_monomial() const {
+            return monomials_.back();
+        }
+
+        const Field& get_major_coefficient() const {
+            return coefficients_.back();
+        }
+
+        void push_back(const MonomialType& monomial, const Field& coefficient) {
+            monomials_.push_back(monomial);
+            coefficients_.push_back(coefficient);
+        }
+
+        void add(const MonomialType& monomial, const Field& coefficient) {
+            update(monomial, coefficient, false);
+        }
+
+        void subtract(const MonomialType& monomial, const Field& coefficient) {
+            update(monomial, coefficient, true);
+        }
+
+        void add(const VectorTerms& other) {
+            merge(other, false, nullptr, nullptr, false);
+        }
+
+        void subtract(const VectorTerms& other) {
+            merge(other, false, nullptr, nullptr, true);
+        }
+
+        void subtract_multiple(const VectorTerms& other, const MonomialType& monomial, const Field& coefficient, bool skip_major) {
+            merge(other, skip_major, &monomial, &coefficient, true);
+        }
+
+        void multiply(const Field& coefficient) {
+            for (auto& value : coefficients_) {
+                value *= coefficient;
+            }
+        }
+
+        void divide(const Field& coefficient) {
+            for (auto& value : coefficients_) {
+                value /= coefficient;
+            }
+        }
+
+        void multiply(const MonomialType& monomial) {
+            if constexpr (MonomialType::IS_MULTILINEAR) {
+                *this = get_product(size(), monomial);
+                return;
+            }
+            for (auto& value : monomials_) {
+                value *= monomial;
+            }
+        }
+
+    private:
+        void update(const MonomialType& monomial, const Field& coefficient, bool is_subtraction) {
+            if (monomials_.empty() || Compare()(monomials_.back(), monomial)) {
+                push_back(monomial, is_subtraction ? Field() - coefficient : coefficient);
+                return;
+            }
+            const size_t position = std::lower_bound(monomials_.begin(), monomials_.end(), monomial, Compare()) - monomials_.begin();
+            if (monomials_[position] == monomial) {
+                if (is_subtraction) {
+                    coefficients_[position] -= coefficient;
+                } else {
+                    coefficients_[position] += coefficient;
+                }
+                if (coefficients_[position].is_zero()) {
+                    monomials_.erase(monomials_.begin() + position);
+                    coefficients_.erase(coefficients_.begin() + position);
+                }
+                return;
+            }
+            monomials_.insert(monomials_.begin() + position, monomial);
+            coefficients_.insert(coefficients_.begin() + position, is_subtraction ? Field() - coefficient : coefficient);
+        }
+
+        // Adds or subtracts factor * shift * other, both sequences are sorted, so it is a single merge.
+        void merge(const VectorTerms& other, bool skip_major, const MonomialType* shift, const Field* factor, bool is_subtraction) {
+            if (&other == this) {
+                const VectorTerms copy(other);
+                merge(copy, skip_major, shift, factor, is_subtraction);
+                return;
+            }
+            const size_t count = (skip_major && !other.empty() ? other.size() - 1 : other.size());
+            if (count == 0) {
+                return;
+            }
+            if constexpr (MonomialType::IS_MULTILINEAR) {
+                if (shift != nullptr) {
+                    merge(other.get_product(count, *shift), false, nullptr, factor, is_subtraction);
+                    return;
+                }
+            }
+            static thread_local std::vector<MonomialType> monomials;
+            static thread_local std::vector<Field> coefficients;
+            monomials.clear();
+            coefficients.clear();
+            monomials.reserve(size() + count);
+            coefficients.reserve(size() + count);
+            Compare cmp;
+            MonomialType shifted;
+            size_t i = 0;
+            for (size_t j = 0; j < count; ++j) {
+                const MonomialType* monomial = &other.monomials_[j];
+                if (shift != nullptr) {
+                    shifted = other.monomials_[j];
+                    shifted *= *shift;
+                    monomial = &shifted;
+                }
+                while (i < size() && cmp(monomials_[i], *monomial)) {
+                    monomials.push_back(std::move(monomials_[i]));
+                    coefficients.push_back(std::move(coefficients_[i]));
+                    ++i;
+                }
+                Field value = (factor != nullptr ? other.coefficients_[j] * *factor : other.coefficients_[j]);
+                if (i < size() && !cmp(*monomial, monomials_[i])) {
+                    if (is_subtraction) {
+                        coefficients_[i] -= value;
+                    } else {
+                        coefficients_[i] += value;
+                    }
+                    if (!coefficients_[i].is_zero()) {
+                        monomials.push_back(std::move(monomials_[i]));
+                        coefficients.push_back(std::move(coefficients_[i]));
+                    }
+                    ++i;
+                } else {
+                    monomials.push_back(*monomial);
+                    coefficients.push_back(is_subtraction ? Field() - value : std::move(value));
+                }
+            }
+            for (; i < size(); ++i) {
+                monomials.push_back(std::move(monomials_[i]));
+                coefficients.push_back(std::move(coefficients_[i]));
+            }
+            monomials_.swap(monomials);
+            coefficients_.swap(coefficients);
+        }
+
+        // The first count terms multiplied by the multilinear monomial, sorted again with the equal monomials summed.
+        VectorTerms get_product(size_t count, const MonomialType& monomial) const {
+            std::vector<std::pair<MonomialType, Field>> products;
+            products.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                products.emplace_back(monomials_[i] * monomial, coefficients_[i]);
+            }
+            std::sort(products.begin(), products.end(), [] (const auto& first, const auto& second) {
+                return Compare()(first.first, second.first);
+            });
+            VectorTerms result;
+            for (auto& product : products) {
+                if (result.empty() || result.monomials_.back() != product.first) {
+                    result.push_back(product.first, product.second);
+                    continue;
+                }
+                result.coefficients_.back() += product.second;
+                if (result.coefficients_.back().is_zero()) {
+                    result.monomials_.pop_back();
+                    result.coefficients_.pop_back();
+                }
+            }
+            return result;
+        }
+
+        std::vector<MonomialType> monomials_;
+        std::vector<Field> coefficients_;
+    };
+
+    /*
+     * Terms over the field of two elements: every coefficient is one, so only the monomials are
+     * kept, sorted by Compare. A sum is the symmetric difference of the monomials, which is a
+     * single merge. The products by multilinear monomials (BooleanMonomial) are sorted again and
+     * the equal ones cancel in pairs.
+     */
+    template <class Field, class Compare>
+    class BooleanTerms {
+    public:
+        using MonomialType = typename FieldMonomial<Field>::Type;
+
+        class const_iterator {
+        public:
+            using iterator_category = std::bidirectional_iterator_tag;
+            using value_type = std::pair<const MonomialType&, const Field&>;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = value_type;
+
+            const_iterator() = default;
+
+            const_iterator(const BooleanTerms* terms, size_t index) : terms_(terms), index_(index) {}
+
+            reference operator*() const {
+                return {terms_->monomials_[index_], get_one()};
+            }
+
+            const_iterator& operator++() {
+                ++index_;
+                return *this;
+            }
+
+            const_iterator operator++(int) {
+                const_iterator result = *this;
+                ++index_;
+                return result;
+            }
+
+            const_iterator& operator--() {
+                --index_;
+                return *this;
+            }
+
+            const_iterator operator--(int) {
+                const_iterator result = *this;
+                --index_;
+                return result;
+            }
+
+            friend bool operator==(const const_iterator& first, const const_iterator& second) {
+                return first.index_ == second.index_;
+            }
+
+            friend bool operator!=(const const_iterator& first, const const_iterator& second) {
+                return !(first == second);
+            }
+
+        private:
+            const BooleanTerms* terms_ = nullptr;
+            size_t index_ = 0;
+        };
+
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+        BooleanTerms() = default;
+
+        explicit BooleanTerms(std::map<MonomialType, Field, Compare>&& terms) {
+            monomials_.reserve(terms.size());
+            for (auto& term : terms) {
+                if (!term.second.is_zero()) {
+                    monomials_.push_back(term.first);
+                }
+            }
+        }
+
+        friend bool operator==(const BooleanTerms& first, const BooleanTerms& second) {
+            return first.monomials_ == second.monomials_;
+        }
+
+        const_iterator begin() const {
+            return const_iterator(this, 0);
+        }
+
+        const_iterator end() const {
+            return const_iterator(this, monomials_.size());
+        }
+
+        const_reverse_iterator rbegin() const {
+            return const_reverse_iterator(end());
+        }
+
+        const_reverse_iterator rend() const {
+            return const_reverse_iterator(begin());
+        }
+
+        bool empty() const {
+            return monomials_.empty();
+        }
+
+        size_t size() const {
+            return monomials_.size();
+        }
+
+        void clear() {
+            monomials_.clear();
+        }
+
+        const MonomialType& get_major_monomial() const {
+            return monomials_.back();
+        }
+
+        const Field& get_major_coefficient() const {
+            return get_one();
+        }
+
+        void push_back(const MonomialType& monomial, const Field& coefficient) {
+            assert(((void)"the coefficient should be one", coefficient.is_one()));
+            monomials_.push_back(monomial);
+        }
+
+        void add(const MonomialType& monomial, const Field& coefficient) {
+            assert(((void)"the coefficient should be one", coefficient.is_one()));
+            toggle(monomial);
+        }
+
+        void subtract(const MonomialType& monomial, const Field& coefficient) {
+            assert(((void)"the coefficient should be one", coefficient.is_one()));
+            toggle(monomial);
+        }
+
+        void add(const BooleanTerms& other) {
+            merge(other, false, nullptr);
+        }
+
+        void subtract(const BooleanTerms& other) {
+            merge(other, false, nullptr);
+        }
+
+        void subtract_multiple(const BooleanTerms& other, const MonomialType& monomial, const Field& coefficient, bool skip_major) {
+            assert(((void)"the coefficient should be one", coefficient.is_one()));
+            merge(other, skip_major, &monomial);
+        }
+
+        // The nonzero coefficient is one.
+        void multiply(const Field&) {}
+
+        void divide(const Field&) {}
+
+        void multiply(const MonomialType& monomial) {
+            get_product(monomials_.size(), monomial, monomials_);
+        }
+
+    private:
+        static const Field& get_one() {
+            static const Field one(1);
+            return one;
+        }
+
+        void toggle(const MonomialType& monomial) {
+            const auto position = std::lower_bound(monomials_.begin(), monomials_.end(), monomial, Compare());
+            if (position != monomials_.end() && *position == monomial) {
+                monomials_.erase(position);
+            } else {
+                monomials_.insert(position, monomial);
+            }
+        }
+
+        // The products of the first count monomials by the monomial, sorted, the equal ones cancel in pairs.
+        void get_product(size_t count, const MonomialType& monomial, std::vector<MonomialType>& result) const {
+            std::vector<MonomialType> products;
+            products.reserve(count);
+            for (size_t i = 0; i < count; ++i) {
+                products.push_back(monomials_[i] * monomial);
+            }
+            if constexpr (MonomialType::IS_MULTILINEAR) {
+                std::sort(products.begin(), products.end(), Compare());
+                size_t size = 0;
+                for (auto& product : products) {
+                    if (size > 0 && products[size - 1] == product) {
+                        --size;
+                    } else {
+                        std::swap(products[size++], product);
+                    }
+                }
+                products.resize(size);
+            }
+            result.swap(products);
+        }
+
+        // Adds shift * other, the symmetric difference of two sorted sequences is a single merge.
+        void merge(const BooleanTerms& other, bool skip_major, const MonomialType* shift) {
+            if (&other == this) {
+                const BooleanTerms copy(other);
+                merge(copy, skip_major, shift);
+                return;
+            }
+            const size_t count = (skip_major && !other.empty() ? other.size() - 1 : other.size());
+            if (count == 0) {
+                return;
+            }
+            static thread_local std::vector<MonomialType> shifted;
+            const MonomialType* summands = other.monomials_.data();
+            size_t summands_count = count;
+            if (shift != nullptr) {
+                other.get_product(count, *shift, shifted);
+                summands = shifted.data();
+                summands_count = shifted.size();
+            }
+            static thread_local std::vector<MonomialType> monomials;
+            monomials.clear();
+            monomials.reserve(size() + summands_count);
+            Compare cmp;
+            size_t i = 0;
+            for (size_t j = 0; j < summands_count; ++j) {
+                while (i < size() && cmp(monomials_[i], summands[j])) {
+                    monomials.push_back(std::move(monomials_[i++]));
+                }
+                if (i < size() && !cmp(summands[j], monomials_[i])) {
+                    ++i;
+                } else {
+                    monomials.push_back(summands[j]);
+                }
+            }
+            for (; i < size(); ++i) {
+                monomials.push_back(std::move(monomials_[i]));
+            }
+            monomials_.swap(monomials);
+        }
+
+        std::vector<MonomialType> monomials_;
+    };
+}
+
+#endif
@@ -0,0 +1,148 @@
+#ifndef GROEBNER_BASIS_THREAD_POOL_H
+#define GROEBNER_BASIS_THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace polynomial {
+
+    /*
+     * Work-stealing thread pool. Every thread owns a deque of task indices, it takes the tasks from
+     * the back of its own deque and steals from the front of the other deques when its deque is
+     * empty, so long tasks don't leave the other threads idle. The calling thread of parallel_for
+     * works as the thread number 0, so a pool of one thread runs everything in place.
+     */
+    class ThreadPool {
+    public:
+        explicit ThreadPool(size_t threads_count) : queues_(std::max<size_t>(threads_count, 1)) {
+            for (size_t i = 1; i < queues_.size(); ++i) {
+                threads_.emplace_back([this, i] {
+                    work(i);
+                });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                is_stopped_ = true;
+            }
+            wake_.notify_all();
+            for (auto& thread : threads_) {
+                thread.join();
+            }
+        }
+
+        size_t get_threads_count() const {
+            return queues_.size();
+        }
+
+        // Runs task(i) for all i in [0, count) and waits for all of them.
+        template <class Task>
+        void parallel_for(size_t count, Task task) {
+            if (count == 0) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                task_ = [&task] (size_t index) {
+                    task(index);
+                };
+                pending_ = count;
+                for (size_t i = 0; i < count; ++i) {
+                    auto& queue = queues_[i % queues_.size()];
+                    std::lock_guard<std::mutex> queue_lock(queue.mutex);
+                    queue.tasks.push_back(i);
+                }
+                ++generation_;
+            }
+            wake_.notify_all();
+            run_tasks(0);
+            std::unique_lock<std::mutex> lock(mutex_);
+            done_.wait(lock, [this] {
+                return pending_ == 0;
+            });
+            task_ = nullptr;
+        }
+
+    private:
+        struct TaskQueue {
+            std::mutex mutex;
+            std::deque<size_t> tasks;
+        };
+
+        bool pop(size_t owner, size_t& index) {
+            auto& queue = queues_[owner];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.tasks.empty()) {
+                return false;
+            }
+            index = queue.tasks.back();
+            queue.tasks.pop_back();
+            return true;
+        }
+
+        bool steal(size_t thief, size_t& index) {
+            for (size_t i = 1; i < queues_.size(); ++i) {
+                auto& queue = queues_[(thief + i) % queues_.size()];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                if (!queue.tasks.empty()) {
+                    index = queue.tasks.front();
+                    queue.tasks.pop_front();
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        void run_tasks(size_t owner) {
+            size_t index = 0;
+            while (pop(owner, index) || steal(owner, index)) {
+                task_(index);
+                if (pending_.fetch_sub(1) == 1) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    done_.notify_all();
+                }
+            }
+        }
+
+        void work(size_t owner) {
+            size_t generation = 0;
+            while (true) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex_);
+                    wake_.wait(lock, [this, generation] {
+                        return is_stopped_ || generation_ != generation;
+                    });
+                    if (is_stopped_) {
+                        return;
+                    }
+                    generation = generation_;
+                }
+                run_tasks(owner);
+            }
+        }
+
+        std::vector<TaskQueue> queues_;
+        std::vector<std::thread> threads_;
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable done_;
+        std::function<void(size_t)> task_;
+        std::atomic<size_t> pending_{0};
+        size_t generation_ = 0;
+        bool is_stopped_ = false;
+    };
+}
+
+#endif
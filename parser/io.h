@@ -8,11 +8,13 @@
 #include "parser.h"
 
 #include <istream>
+#include <string>
 
-std::istream& operator>>(std::istream& in, parser::PolynomialType& polynomial) {
+template <class Field, class Compare, template <class, class> class Terms>
+std::istream& operator>>(std::istream& in, polynomial::Polynomial<Field, Compare, Terms>& polynomial) {
     std::string polynomial_str;
     in >> polynomial_str;
-    polynomial = parser::parse_polynomial(polynomial_str);
+    polynomial = parser::parse_polynomial<Field, Compare, Terms>(polynomial_str);
     return in;
 }
 
@@ -0,0 +1,226 @@
+/*
+ * boost library should be installed to use this functions
+ */
+
+#ifndef GROEBNER_BASIS_LOADER_H
+#define GROEBNER_BASIS_LOADER_H
+
+#include "parser.h"
+#include "../library/ideal.h"
+#include "../library/thread_pool.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace parser {
+
+    // The size of the chunks read from a stream, a chunk is extended while it has no complete polynomial.
+    constexpr size_t LOADER_CHUNK_SIZE = 1u << 24u;
+    // The polynomials of a chunk are parsed in about this number of tasks per thread.
+    constexpr size_t LOADER_TASKS_PER_THREAD = 8;
+
+    struct LoaderStats {
+        size_t polynomials = 0;
+        size_t bytes = 0;
+        size_t threads = 1;
+        double seconds = 0;
+
+        // Megabytes (10^6 bytes) per second of the wall time.
+        double get_throughput() const {
+            return seconds > 0 ? bytes / seconds / 1e6 : 0;
+        }
+    };
+
+    std::ostream& operator<<(std::ostream& out, const LoaderStats& stats) {
+        out << "polynomials: " << stats.polynomials << ", bytes: " << stats.bytes << ", threads: " << stats.threads;
+        out << ", working time: " << stats.seconds << ", throughput: " << stats.get_throughput() << " MB/s";
+        return out;
+    }
+
+    // Read-only private mapping of a file, empty if the file can't be mapped.
+    class MappedFile {
+    public:
+        explicit MappedFile(const std::string& path) {
+            const int descriptor = open(path.c_str(), O_RDONLY);
+            if (descriptor < 0) {
+                return;
+            }
+            struct stat status;
+            if (fstat(descriptor, &status) == 0) {
+                is_open_ = true;
+                size_ = static_cast<size_t>(status.st_size);
+            }
+            if (is_open_ && size_ > 0) {
+                void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, descriptor, 0);
+                if (data == MAP_FAILED) {
+                    is_open_ = false;
+                    size_ = 0;
+                } else {
+                    data_ = static_cast<const char*>(data);
+                    madvise(data, size_, MADV_SEQUENTIAL);
+                }
+            }
+            close(descriptor);
+        }
+
+        MappedFile(const MappedFile&) = delete;
+
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        ~MappedFile() {
+            if (data_ != nullptr) {
+                munmap(const_cast<char*>(data_), size_);
+            }
+        }
+
+        bool is_open() const {
+            return is_open_;
+        }
+
+        std::string_view get_view() const {
+            return {data_, size_};
+        }
+
+    private:
+        const char* data_ = nullptr;
+        size_t size_ = 0;
+        bool is_open_ = false;
+    };
+
+    /*
+     * Bulk input of polynomial systems: the polynomials are separated by new lines or by ';', the
+     * empty ones are skipped. A file is mapped into memory and a stream is read in chunks of
+     * chunk_size bytes, the polynomials are cut as views of the input without copying and parsed
+     * in parallel, the order of the polynomials is kept. With a symbol table the names of a chunk
+     * are added before the parsing in the order of appearance, so the numbering of the variables
+     * doesn't depend on the threads and the parallel parsing only looks the names up in the table.
+     */
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    class IdealLoader {
+    public:
+        using PolynomialType = polynomial::Polynomial<Field, Compare, Terms>;
+        using IdealType = polynomial::Ideal<Field, Compare, Terms>;
+
+        explicit IdealLoader(size_t threads_count = 1, size_t chunk_size = LOADER_CHUNK_SIZE)
+            : pool_(threads_count), chunk_size_(std::max<size_t>(chunk_size, 1)) {}
+
+        // The table is shared by the loads until it is reset by nullptr.
+        void set_symbol_table(SymbolTable* symbols) {
+            symbols_ = symbols;
+        }
+
+        // Returns false if the file can't be read.
+        bool load_file(const std::string& path) {
+            const auto start = std::chrono::steady_clock::now();
+            MappedFile file(path);
+            if (!file.is_open()) {
+                return false;
+            }
+            const auto input = file.get_view();
+            parse(input);
+            stats_.bytes += input.size();
+            finish(start);
+            return true;
+        }
+
+        // Returns false if the stream fails before its end.
+        bool load_stream(std::istream& in) {
+            const auto start = std::chrono::steady_clock::now();
+            // The tail of the previous chunk after the last separator and the next chunk.
+            std::string buffer;
+            while (in) {
+                const size_t carried = buffer.size();
+                buffer.resize(carried + chunk_size_);
+                in.read(&buffer[carried], static_cast<std::streamsize>(chunk_size_));
+                const auto count = static_cast<size_t>(in.gcount());
+                buffer.resize(carried + count);
+                stats_.bytes += count;
+                size_t end = buffer.size();
+                if (in) {
+                    end = buffer.find_last_of("\n;");
+                    if (end == std::string::npos) {
+                        continue;
+                    }
+                }
+                parse(std::string_view(buffer.data(), end));
+                buffer.erase(0, end);
+            }
+            finish(start);
+            return !in.bad();
+        }
+
+        IdealType release() {
+            return std::move(polynomials_);
+        }
+
+        const LoaderStats& get_stats() const {
+            return stats_;
+        }
+
+    private:
+        void parse(std::string_view input) {
+            std::vector<std::string_view> sources;
+            size_t from = 0;
+            for (size_t i = 0; i <= input.size(); ++i) {
+                if (i == input.size() || input[i] == '\n' || input[i] == ';') {
+                    if (!is_blank(input.substr(from, i - from))) {
+                        sources.push_back(input.substr(from, i - from));
+                    }
+                    from = i + 1;
+                }
+            }
+            if (symbols_ != nullptr) {
+                for (const auto& source : sources) {
+                    symbols_->add_all(source);
+                }
+            }
+            const size_t offset = polynomials_.size();
+            polynomials_.resize(offset + sources.size());
+            const size_t tasks_count = std::min(sources.size(), pool_.get_threads_count() * LOADER_TASKS_PER_THREAD);
+            const auto context = polynomial::FieldContext<Field>::get();
+            const SymbolTable* symbols = symbols_;
+            pool_.parallel_for(tasks_count, [this, &sources, offset, tasks_count, context, symbols] (size_t task) {
+                polynomial::FieldContext<Field>::set(context);
+                const size_t begin = sources.size() * task / tasks_count;
+                const size_t end = sources.size() * (task + 1) / tasks_count;
+                for (size_t i = begin; i < end; ++i) {
+                    const auto& source = sources[i];
+                    polynomials_[offset + i] = PolynomialParser<Field, Compare, Terms>(source, 0, source.size(), symbols).parse_polynomial();
+                }
+            });
+        }
+
+        static bool is_blank(std::string_view source) {
+            return std::all_of(source.begin(), source.end(), [] (char c) {
+                return std::isspace(static_cast<unsigned char>(c));
+            });
+        }
+
+        void finish(std::chrono::steady_clock::time_point start) {
+            stats_.polynomials = polynomials_.size();
+            stats_.threads = pool_.get_threads_count();
+            stats_.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+
+        polynomial::ThreadPool pool_;
+        size_t chunk_size_;
+        SymbolTable* symbols_ = nullptr;
+        std::vector<PolynomialType> polynomials_;
+        LoaderStats stats_;
+    };
+}
+
+#endif
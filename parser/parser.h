@@ -7,9 +7,14 @@
 
 #include "../fields/rational.h"
 #include "../library/polynomial.h"
+#include "symbols.h"
 
 #include <cassert>
-#include <sstream>
+#include <cctype>
+#include <functional>
+#include <map>
+#include <string_view>
+#include <vector>
 
 namespace parser {
 
@@ -17,117 +22,276 @@ namespace parser {
     using MonomialType = polynomial::Monomial;
     using PolynomialType = polynomial::Polynomial<RationalType>;
 
-    RationalType parse_coefficient(const std::string& s, size_t l, size_t r) {
-        std::string now = "";
-        for (size_t i = l; i < r; ++i) {
-            if (isdigit(s[i]) || s[i] == '/' || s[i] == '-') {
-                now += s[i];
+    /*
+     * One-pass parser of the grammar
+     *     polynomial = [sign] term {sign term},    term = factor {'*' factor},
+     *     factor = coefficient | '(' [sign] coefficient ')' | variable ['^' degree],
+     *     coefficient = number ['/' number],
+     * with spaces allowed between the tokens, the parenthesized signed coefficients are printed
+     * by the fields for the negative values. The variables are x_i, or any identifiers numbered by
+     * a symbol table if it is given. The exponents and the coefficient of a term are
+     * accumulated in place and the terms are collected in one map. The numbers are read digit by
+     * digit in the arithmetic of the field, so, for example, the coefficients modulo a prime are
+     * reduced on the fly and never go through GMP.
+     */
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    class PolynomialParser {
+    public:
+        using PolynomialType = polynomial::Polynomial<Field, Compare, Terms>;
+        using MonomialType = typename PolynomialType::MonomialType;
+
+        // The new names are added to the symbol table.
+        PolynomialParser(std::string_view s, size_t l, size_t r, SymbolTable* symbols = nullptr)
+            : s_(s), position_(l), end_(r), symbols_(symbols), known_symbols_(symbols) {
+            init_digits();
+        }
+
+        // All the names should be in the symbol table, it is only read, so it can be shared by the threads.
+        PolynomialParser(std::string_view s, size_t l, size_t r, const SymbolTable* symbols)
+            : s_(s), position_(l), end_(r), symbols_(nullptr), known_symbols_(symbols) {
+            init_digits();
+        }
+
+        PolynomialType parse_polynomial() {
+            std::map<MonomialType, Field, Compare> terms;
+            skip_spaces();
+            if (position_ == end_) {
+                return PolynomialType();
+            }
+            bool is_subtraction = consume('-');
+            if (!is_subtraction) {
+                consume('+');
             }
+            while (true) {
+                Field coefficient = parse_term();
+                if (is_subtraction) {
+                    coefficient = Field() - coefficient;
+                }
+                add_term(terms, coefficient);
+                if (position_ == end_) {
+                    break;
+                }
+                assert(((void)"terms should be separated by + or -", s_[position_] == '+' || s_[position_] == '-'));
+                is_subtraction = s_[position_++] == '-';
+            }
+            return PolynomialType(std::move(terms));
         }
-        std::stringstream sin(now);
-        math::RationalType value;
-        sin >> value;
-        return value;
-    }
 
-    MonomialType parse_monomial(const std::string& s, size_t l, size_t r) {
-        if (l + 2 >= r) {
-            return MonomialType();
+        PolynomialType parse_term_polynomial() {
+            skip_spaces();
+            const Field coefficient = parse_term();
+            assert(((void)"a single term is expected", position_ == end_));
+            return PolynomialType(get_monomial(), coefficient);
         }
-        assert(((void)"variable should start with x_", s[l] == 'x' && s[l + 1] == '_'));
-        std::string now = "";
-        for (size_t i = l + 2; i < r; ++i) {
-            if (!isdigit(s[i])) {
-                l = i;
-                break;
+
+        MonomialType parse_monomial() {
+            skip_spaces();
+            if (position_ == end_) {
+                return MonomialType();
+            }
+            const Field coefficient = parse_term();
+            assert(((void)"a monomial should have no coefficient", position_ == end_ && coefficient == Field(1)));
+            return get_monomial();
+        }
+
+        Field parse_coefficient() {
+            skip_spaces();
+            if (consume('(')) {
+                skip_spaces();
+                const bool is_negative = consume('-');
+                if (!is_negative) {
+                    consume('+');
+                }
+                const Field value = parse_coefficient();
+                const bool is_closed = consume(')');
+                assert(((void)"a coefficient should be closed by )", is_closed));
+                skip_spaces();
+                return is_negative ? Field() - value : value;
+            }
+            Field value = parse_number();
+            if (consume('/')) {
+                skip_spaces();
+                value /= parse_number();
             }
-            now += s[i];
+            skip_spaces();
+            return value;
         }
-        now += " ";
-        bool degree_found = false;
-        for (size_t i = l; i < r; i++) {
-            if (s[i] == '^') {
-                degree_found = true;
-                l = i + 1;
-                break;
+
+    private:
+        void init_digits() {
+            for (size_t i = 1; i <= 10; ++i) {
+                digits_[i] = digits_[i - 1] + Field(1);
             }
         }
-        if (degree_found) {
-            for (size_t i = l; i < r; ++i) {
-                if (!isdigit(s[i])) {
-                    break;
+
+        // Reads the factors of a term into degree_, returns its coefficient and stops at the next sign.
+        Field parse_term() {
+            Field coefficient(1);
+            degree_.clear();
+            do {
+                skip_spaces();
+                if (position_ < end_ && is_identifier_start(s_[position_])) {
+                    parse_variable();
+                } else {
+                    coefficient *= parse_coefficient();
                 }
-                now += s[i];
-            }
-        } else {
-            now += "1";
-        }
-        std::stringstream sin(now);
-        size_t pos;
-        polynomial::MonomialDegreeType degree;
-        sin >> pos >> degree;
-        std::vector<polynomial::MonomialDegreeType> degrees(pos + 1, 0);
-        degrees[pos] = degree;
-        return MonomialType(std::move(degrees));
-    }
+                skip_spaces();
+            } while (consume('*'));
+            return coefficient;
+        }
 
-    PolynomialType parse_atom(const std::string& s, size_t l, size_t r) {
-        for (size_t i = l; i < r; ++i) {
-            if (s[i] == 'x') {
-                return PolynomialType(parse_monomial(s, i, r), 1);
+        void parse_variable() {
+            const size_t from = position_;
+            while (position_ < end_ && is_identifier_char(s_[position_])) {
+                ++position_;
             }
+            const auto name = s_.substr(from, position_ - from);
+            const size_t index = get_index(name);
+            polynomial::MonomialDegreeType degree = 1;
+            skip_spaces();
+            if (consume('^')) {
+                skip_spaces();
+                degree = parse_unsigned<polynomial::MonomialDegreeType>();
+            }
+            if (degree_.size() <= index) {
+                degree_.resize(index + 1);
+            }
+            degree_[index] += degree;
         }
-        return PolynomialType({}, parse_coefficient(s, l, r));
-    }
 
-    PolynomialType parse_term(const std::string& s, size_t l, size_t r) {
-        PolynomialType result({}, 1);
-        size_t from = l;
-        for (size_t i = l; i < r; ++i) {
-            if (s[i] == '*') {
-                result *= parse_atom(s, from, i);
-                from = i + 1;
-                continue;
+        template <typename T>
+        T parse_unsigned() {
+            assert(((void)"a number is expected", position_ < end_ && std::isdigit(static_cast<unsigned char>(s_[position_]))));
+            T value = 0;
+            for (; position_ < end_ && std::isdigit(static_cast<unsigned char>(s_[position_])); ++position_) {
+                value = value * 10 + static_cast<T>(s_[position_] - '0');
             }
+            return value;
         }
-        result *= parse_atom(s, from, r);
-        return result;
-    }
 
-    PolynomialType parse_term(const std::string& s) {
-        return parse_term(s, 0, s.size());
-    }
+        size_t get_index(std::string_view name) const {
+            if (symbols_ != nullptr) {
+                return symbols_->add(name);
+            }
+            if (known_symbols_ != nullptr) {
+                const size_t index = known_symbols_->find(name);
+                assert(((void)"variable should be in the symbol table", index != SymbolTable::NONE));
+                return index;
+            }
+            return get_x_index(name);
+        }
 
-    PolynomialType parse_polynomial(const std::string& s, size_t l, size_t r) {
-        PolynomialType result;
-        bool is_plus = true;
-        size_t from = l;
-        for (size_t i = l; i < r; ++i) {
-            if (s[i] == '+' || s[i] == '-') {
-                if (is_plus) {
-                    result += parse_term(s, from, i);
-                } else {
-                    result -= parse_term(s, from, i);
+        // The index of x_i without a symbol table.
+        static size_t get_x_index(std::string_view name) {
+            assert(((void)"variable should start with x_", name.size() > 2 && name[0] == 'x' && name[1] == '_'));
+            size_t index = 0;
+            for (size_t i = 2; i < name.size(); ++i) {
+                assert(((void)"variable should be x_ and its number", std::isdigit(static_cast<unsigned char>(name[i]))));
+                index = index * 10 + static_cast<size_t>(name[i] - '0');
+            }
+            return index;
+        }
+
+        Field parse_number() {
+            assert(((void)"a number is expected", position_ < end_ && std::isdigit(static_cast<unsigned char>(s_[position_]))));
+            Field value;
+            for (; position_ < end_ && std::isdigit(static_cast<unsigned char>(s_[position_])); ++position_) {
+                value = value * digits_[10] + digits_[s_[position_] - '0'];
+            }
+            return value;
+        }
+
+        // The constructor of a monomial reads the exponents, so the buffer of degree_ is kept for the next term.
+        MonomialType get_monomial() {
+            return MonomialType(std::move(degree_));
+        }
+
+        void add_term(std::map<MonomialType, Field, Compare>& terms, const Field& coefficient) {
+            if (coefficient.is_zero()) {
+                return;
+            }
+            auto [term, is_inserted] = terms.emplace(get_monomial(), coefficient);
+            if (!is_inserted) {
+                term->second += coefficient;
+                if (term->second.is_zero()) {
+                    terms.erase(term);
                 }
-                is_plus = (s[i] == '+');
-                from = i + 1;
-                continue;
             }
         }
-        if (is_plus) {
-            result += parse_term(s, from, r);
-        } else {
-            result -= parse_term(s, from, r);
+
+        bool consume(char c) {
+            if (position_ < end_ && s_[position_] == c) {
+                ++position_;
+                return true;
+            }
+            return false;
+        }
+
+        void skip_spaces() {
+            while (position_ < end_ && std::isspace(static_cast<unsigned char>(s_[position_]))) {
+                ++position_;
+            }
         }
-        return result;
+
+        std::string_view s_;
+        size_t position_;
+        size_t end_;
+        SymbolTable* symbols_;
+        const SymbolTable* known_symbols_;
+        std::vector<polynomial::MonomialDegreeType> degree_;
+        // digits_[i] is i in the field, the numbers are built by Horner's rule.
+        Field digits_[11] = {};
+    };
+
+    template <class Field = RationalType>
+    Field parse_coefficient(std::string_view s, size_t l, size_t r) {
+        return PolynomialParser<Field>(s, l, r).parse_coefficient();
+    }
+
+    template <class Field = RationalType>
+    typename polynomial::FieldMonomial<Field>::Type parse_monomial(std::string_view s, size_t l, size_t r) {
+        return PolynomialParser<Field>(s, l, r).parse_monomial();
+    }
+
+    template <class Field = RationalType>
+    typename polynomial::FieldMonomial<Field>::Type parse_monomial(std::string_view s) {
+        return parse_monomial<Field>(s, 0, s.size());
+    }
+
+    template <class Field = RationalType>
+    typename polynomial::FieldMonomial<Field>::Type parse_monomial(std::string_view s, SymbolTable& symbols) {
+        return PolynomialParser<Field>(s, 0, s.size(), &symbols).parse_monomial();
+    }
+
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    polynomial::Polynomial<Field, Compare, Terms> parse_term(std::string_view s, size_t l, size_t r) {
+        return PolynomialParser<Field, Compare, Terms>(s, l, r).parse_term_polynomial();
+    }
+
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    polynomial::Polynomial<Field, Compare, Terms> parse_term(std::string_view s) {
+        return parse_term<Field, Compare, Terms>(s, 0, s.size());
+    }
+
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    polynomial::Polynomial<Field, Compare, Terms> parse_polynomial(std::string_view s, size_t l, size_t r) {
+        return PolynomialParser<Field, Compare, Terms>(s, l, r).parse_polynomial();
     }
 
-    MonomialType parse_monomial(const std::string& s) {
-        return parse_monomial(s, 0, s.size());
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    polynomial::Polynomial<Field, Compare, Terms> parse_polynomial(std::string_view s) {
+        return parse_polynomial<Field, Compare, Terms>(s, 0, s.size());
     }
 
-    PolynomialType parse_polynomial(const std::string& s) {
-        return parse_polynomial(s, 0, s.size());
+    template <class Field = RationalType, class Compare = std::less<typename polynomial::FieldMonomial<Field>::Type>,
+              template <class, class> class Terms = polynomial::MapTerms>
+    polynomial::Polynomial<Field, Compare, Terms> parse_polynomial(std::string_view s, SymbolTable& symbols) {
+        return PolynomialParser<Field, Compare, Terms>(s, 0, s.size(), &symbols).parse_polynomial();
     }
 }
 
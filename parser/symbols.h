@@ -0,0 +1,119 @@
+#ifndef GROEBNER_BASIS_SYMBOLS_H
+#define GROEBNER_BASIS_SYMBOLS_H
+
+#include "../library/monomial.h"
+
+#include <cctype>
+#include <deque>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace parser {
+
+    // Identifiers are a letter or '_' followed by letters, digits and '_'.
+    bool is_identifier_start(char c) {
+        return std::isalpha(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    bool is_identifier_char(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    /*
+     * Interned variable names: a name gets the next index when it is added for the first time, so
+     * the variables are numbered in the order of their first appearance, unless the names are
+     * given in advance. One table is shared by all polynomials of a system, and the polynomials
+     * are printed with the names after out << symbols.get_variable_names().
+     */
+    class SymbolTable {
+    public:
+        static constexpr size_t NONE = std::numeric_limits<size_t>::max();
+
+        SymbolTable() = default;
+
+        explicit SymbolTable(const std::vector<std::string>& names) {
+            for (const auto& name : names) {
+                add(name);
+            }
+        }
+
+        // The keys of a copy should view its own names.
+        SymbolTable(const SymbolTable& other) {
+            for (const auto& name : other.names_) {
+                add(name);
+            }
+        }
+
+        SymbolTable(SymbolTable&&) = default;
+
+        SymbolTable& operator=(const SymbolTable& other) {
+            if (this != &other) {
+                indices_.clear();
+                names_.clear();
+                for (const auto& name : other.names_) {
+                    add(name);
+                }
+            }
+            return *this;
+        }
+
+        SymbolTable& operator=(SymbolTable&&) = default;
+
+        // Returns the index of the name, a new name is appended. The table isn't changed for a known name.
+        size_t add(std::string_view name) {
+            const size_t index = find(name);
+            if (index != NONE) {
+                return index;
+            }
+            names_.emplace_back(name);
+            indices_.emplace(names_.back(), names_.size() - 1);
+            return names_.size() - 1;
+        }
+
+        // Adds the identifiers of the text in the order of appearance.
+        void add_all(std::string_view text) {
+            for (size_t i = 0; i < text.size();) {
+                if (!is_identifier_char(text[i])) {
+                    ++i;
+                    continue;
+                }
+                const size_t from = i;
+                while (i < text.size() && is_identifier_char(text[i])) {
+                    ++i;
+                }
+                if (is_identifier_start(text[from])) {
+                    add(text.substr(from, i - from));
+                }
+            }
+        }
+
+        // Returns NONE if there is no such name.
+        size_t find(std::string_view name) const {
+            const auto position = indices_.find(name);
+            return position == indices_.end() ? NONE : position->second;
+        }
+
+        const std::string& get_name(size_t index) const {
+            return names_[index];
+        }
+
+        size_t size() const {
+            return names_.size();
+        }
+
+        polynomial::VariableNames get_variable_names() const {
+            return {&names_};
+        }
+
+    private:
+        // The keys view the names, the deque doesn't move its elements on the growth, so the lookup doesn't allocate.
+        std::unordered_map<std::string_view, size_t> indices_;
+        std::deque<std::string> names_;
+    };
+}
+
+#endif
@@ -0,0 +1,194 @@
+#include "framework/ut.h"
+
+#include "../fields/modular.h"
+#include "../library/ideal.h"
+
+#include <algorithm>
+#include <random>
+#include <sstream>
+
+using namespace math;
+using namespace polynomial;
+
+std::vector<MonomialDegreeType> get_random_degree(std::mt19937& generator, size_t variables_count) {
+    std::vector<MonomialDegreeType> degree(variables_count);
+    for (auto& value : degree) {
+        value = generator() % 3 == 0;
+    }
+    return degree;
+}
+
+template <class Compare, template <class, class> class Terms>
+Polynomial<Boolean, Compare, Terms> get_random_polynomial(std::mt19937& generator, size_t variables_count) {
+    Polynomial<Boolean, Compare, Terms> result;
+    for (size_t i = 0; i < 4; ++i) {
+        result.add(BooleanMonomial(get_random_degree(generator, variables_count)), Boolean(1));
+    }
+    return result;
+}
+
+template <class T>
+std::string to_string(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+template <class Compare>
+void check_order(std::mt19937& generator, size_t variables_count) {
+    auto first = get_random_degree(generator, variables_count);
+    auto second = get_random_degree(generator, variables_count);
+    auto first_copy = first;
+    auto second_copy = second;
+    Monomial first_monomial(std::move(first_copy));
+    Monomial second_monomial(std::move(second_copy));
+    BooleanMonomial first_boolean(std::move(first));
+    BooleanMonomial second_boolean(std::move(second));
+    Compare compare;
+    make_assert(compare(first_boolean, second_boolean) == compare(first_monomial, second_monomial), "the orders agree");
+    make_assert(first_boolean.is_subset(second_boolean) == first_monomial.is_subset(second_monomial), "divisibility agrees");
+}
+
+void test_boolean() {
+    assert_equal(Boolean(1) + Boolean(1), Boolean(), "1 + 1 == 0");
+    assert_equal(Boolean(1) - Boolean(0), Boolean(1), "1 - 0 == 1");
+    assert_equal(Boolean(1) * Boolean(0), Boolean(), "1 * 0 == 0");
+    assert_equal(Boolean(3) / Boolean(1), Boolean(1), "3 / 1 == 1");
+    make_assert(Boolean(-1).is_one() && Boolean(4).is_zero(), "integers modulo 2");
+}
+
+void test_boolean_monomial() {
+    BooleanMonomial a = {1, 0, 1};
+    BooleanMonomial b = {0, 1, 1};
+    assert_equal(a * b, BooleanMonomial({1, 1, 1}), "x_0*x_2 * x_1*x_2 == x_0*x_1*x_2");
+    assert_equal(a * a, a, "x^2 == x");
+    assert_equal((a * b) / b, BooleanMonomial({1}), "x_0*x_1*x_2 / x_1*x_2 == x_0");
+    assert_equal(get_intersection(a, b), BooleanMonomial({0, 0, 1}), "gcd is intersection");
+    assert_equal(BooleanMonomial({0, 2, 0, 5}), BooleanMonomial({0, 1, 0, 1}), "nonzero exponents are ones");
+    assert_equal(to_string(a), std::string("x_0*x_2"), "output");
+    assert_equal(to_string(BooleanMonomial()), std::string("1"), "empty output");
+    make_assert(!a.is_subset(b) && (a * b).is_subset(a), "subset");
+
+    // The monomials with more than 128 variables are stored on the heap.
+    std::vector<MonomialDegreeType> degree(200);
+    degree[3] = degree[130] = degree[199] = 1;
+    BooleanMonomial wide(std::move(degree));
+    assert_equal(wide.get_total_degree(), MonomialDegreeType(3), "wide degree");
+    assert_equal(wide.size(), size_t(200), "wide size");
+    BooleanMonomial product = wide * a;
+    assert_equal(product.get_total_degree(), MonomialDegreeType(5), "wide product degree");
+    assert_equal(product / wide, a, "wide division");
+    assert_equal(product / a, wide, "division by inline");
+    make_assert(product.is_subset(wide) && !wide.is_subset(product), "wide subset");
+
+    std::mt19937 generator(0);
+    for (size_t i = 0; i < 500; ++i) {
+        const size_t variables_count = i % 2 == 0 ? 10 : 150;
+        check_order<LexOrder>(generator, variables_count);
+        check_order<DeglexOrder>(generator, variables_count);
+        check_order<GrevlexOrder>(generator, variables_count);
+    }
+}
+
+template <class Compare, template <class, class> class Terms>
+void check_terms(unsigned seed) {
+    std::mt19937 generator(seed);
+    auto first = get_random_polynomial<Compare, Terms>(generator, 6);
+    auto second = get_random_polynomial<Compare, Terms>(generator, 6);
+    const BooleanMonomial monomial(get_random_degree(generator, 6));
+    Polynomial<Boolean, Compare> map_first, map_second;
+    for (const auto& term : first) {
+        map_first.add(term.first, term.second);
+    }
+    for (const auto& term : second) {
+        map_second.add(term.first, term.second);
+    }
+    assert_equal(to_string(first + second), to_string(map_first + map_second), "sum");
+    assert_equal(to_string(first * second), to_string(map_first * map_second), "product");
+    assert_equal(to_string(first * monomial), to_string(map_first * monomial), "product by monomial");
+    make_assert((first + first).is_zero(), "f + f == 0");
+    make_assert(first * first == first, "f^2 == f");
+}
+
+void test_boolean_terms() {
+    for (unsigned seed = 0; seed < 100; ++seed) {
+        check_terms<LexOrder, BooleanTerms>(seed);
+        check_terms<GrevlexOrder, BooleanTerms>(seed);
+        check_terms<DeglexOrder, VectorTerms>(seed);
+    }
+}
+
+// The reduced basis over Modular<2> with the field equations consists of the boolean basis and the field equations.
+template <class Compare, template <class, class> class Terms>
+void check_basis(unsigned seed, size_t variables_count) {
+    std::mt19937 generator(seed);
+    std::vector<Polynomial<Boolean, Compare, Terms>> system;
+    std::vector<Polynomial<Modular<2>, Compare>> modular_system;
+    for (size_t i = 0; i < 4; ++i) {
+        system.push_back(get_random_polynomial<Compare, Terms>(generator, variables_count));
+        Polynomial<Modular<2>, Compare> polynomial;
+        for (const auto& term : system.back()) {
+            std::vector<MonomialDegreeType> degree(variables_count);
+            for (size_t j = 0; j < variables_count; ++j) {
+                degree[j] = term.first.get_degree(j);
+            }
+            polynomial.add(Monomial(std::move(degree)), Modular<2>(1));
+        }
+        modular_system.push_back(std::move(polynomial));
+    }
+    for (size_t i = 0; i < variables_count; ++i) {
+        std::vector<MonomialDegreeType> square(i + 1), variable(i + 1);
+        square[i] = 2;
+        variable[i] = 1;
+        Polynomial<Modular<2>, Compare> equation;
+        equation.add(Monomial(std::move(square)), Modular<2>(1));
+        equation.add(Monomial(std::move(variable)), Modular<2>(1));
+        modular_system.push_back(std::move(equation));
+    }
+    Ideal<Boolean, Compare, Terms> ideal(std::move(system));
+    Ideal<Modular<2>, Compare> reference(std::move(modular_system));
+    ideal.make_minimal_groebner_basis();
+    reference.make_minimal_groebner_basis();
+    std::vector<std::string> basis, reference_basis;
+    for (const auto& polynomial : ideal.get_basis()) {
+        basis.push_back(to_string(polynomial));
+    }
+    for (const auto& polynomial : reference.get_basis()) {
+        const auto& major = polynomial.get_major_monomial();
+        bool is_multilinear = true;
+        for (size_t i = 0; i < major.size(); ++i) {
+            is_multilinear = is_multilinear && major.get_degree(i) <= 1;
+        }
+        if (!is_multilinear) {
+            continue;
+        }
+        // The coefficients are ones, the constant term is printed as [1 (modulo 2)].
+        std::string element = to_string(polynomial);
+        const std::string one = to_string(Modular<2>(1));
+        for (size_t position = element.find(one); position != std::string::npos; position = element.find(one)) {
+            element.replace(position, one.size(), "1");
+        }
+        reference_basis.push_back(element);
+    }
+    std::sort(basis.begin(), basis.end());
+    std::sort(reference_basis.begin(), reference_basis.end());
+    make_assert(basis == reference_basis, "the boolean basis is the multilinear part of the basis modulo 2");
+}
+
+void test_boolean_ideal() {
+    for (unsigned seed = 0; seed < 30; ++seed) {
+        check_basis<LexOrder, BooleanTerms>(seed, 5);
+        check_basis<GrevlexOrder, BooleanTerms>(seed, 6);
+        check_basis<DeglexOrder, MapTerms>(seed, 5);
+        check_basis<GrevlexOrder, VectorTerms>(seed, 6);
+    }
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_boolean, "Boolean test");
+    runner.run_test(test_boolean_monomial, "Boolean monomial test");
+    runner.run_test(test_boolean_terms, "Boolean terms test");
+    runner.run_test(test_boolean_ideal, "Boolean ideal test");
+    return 0;
+}
@@ -0,0 +1,94 @@
+#include "framework/ut.h"
+
+#include "../library/fraction_free.h"
+
+#include <random>
+
+using namespace math;
+using namespace polynomial;
+
+template <class Compare>
+using RationalPolynomial = Polynomial<Rational, Compare>;
+
+template <class Compare>
+std::vector<RationalPolynomial<Compare>> get_random_system(unsigned seed, MonomialDegreeType degree_limit) {
+    std::mt19937 generator(seed);
+    std::vector<RationalPolynomial<Compare>> result(3);
+    for (auto& polynomial : result) {
+        for (size_t i = 0; i < 4; ++i) {
+            std::vector<MonomialDegreeType> degree(3);
+            for (auto& value : degree) {
+                value = generator() % degree_limit;
+            }
+            const int numerator = static_cast<int>(generator() % 41) - 20;
+            polynomial.add(Monomial(std::move(degree)), Rational(numerator) / Rational(1 + generator() % 7));
+        }
+    }
+    return result;
+}
+
+template <class Compare>
+void check_fraction_free(std::vector<RationalPolynomial<Compare>> system, size_t threads_count) {
+    auto copy = system;
+    Ideal<Rational, Compare> fraction_free(std::move(copy));
+    Ideal<Rational, Compare> reference(std::move(system));
+    make_fraction_free_groebner_basis(fraction_free, threads_count);
+    reference.make_minimal_groebner_basis();
+    make_assert(fraction_free.get_basis() == reference.get_basis(), "fraction-free basis is the reduced basis");
+    make_assert(fraction_free == reference, "the ideals are equal");
+}
+
+void test_integer() {
+    Integer a = 12;
+    Integer b = -18;
+    assert_equal(gcd(a, b), Integer(6), "gcd(12, -18) == 6");
+    assert_equal(gcd(Integer(), b), Integer(18), "gcd(0, -18) == 18");
+    assert_equal(b / Integer(-6), Integer(3), "-18 / -6 == 3");
+    assert_equal(a * b + Integer(216), Integer(), "12 * -18 + 216 == 0");
+    make_assert(b.is_negative() && !a.is_negative() && Integer(1).is_one() && Integer().is_zero(), "predicates");
+}
+
+void test_integer_ideal() {
+    // x^2 - 2y, 3xy - 1 over the integers.
+    Polynomial<Integer, GrevlexOrder> first;
+    first.add(Monomial({2}), Integer(2));
+    first.add(Monomial({0, 1}), Integer(-4));
+    Polynomial<Integer, GrevlexOrder> second;
+    second.add(Monomial({1, 1}), Integer(-3));
+    second.add(Monomial(), Integer(1));
+    Ideal<Integer, GrevlexOrder> ideal({first, second});
+    ideal.make_minimal_groebner_basis();
+    for (const auto& polynomial : ideal.get_basis()) {
+        make_assert(!polynomial.get_major_coefficient().is_negative(), "positive major coefficient");
+        Integer content;
+        for (const auto& term : polynomial) {
+            content = gcd(content, term.second);
+        }
+        make_assert(content.is_one(), "primitive basis element");
+    }
+    make_assert(ideal.contains(first * Monomial({0, 3}) - second * second), "ideal contains a combination");
+}
+
+void test_fraction_free() {
+    std::vector<RationalPolynomial<LexOrder>> system(2);
+    system[0].add(Monomial({2}), Rational(3) / 7);
+    system[0].add(Monomial({0, 1}), Rational(-5) / 11);
+    system[0].add(Monomial(), Rational(1));
+    system[1].add(Monomial({1, 1}), Rational(2));
+    system[1].add(Monomial({0, 0, 1}), Rational(13) / 3);
+    check_fraction_free(system, 1);
+    check_fraction_free(system, 2);
+    for (unsigned seed = 0; seed < 30; ++seed) {
+        // The lexicographic bases of the systems of higher degrees take too long.
+        check_fraction_free(get_random_system<LexOrder>(seed, 2), 1);
+        check_fraction_free(get_random_system<GrevlexOrder>(seed, 3), 1 + seed % 3);
+    }
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_integer, "Integer test");
+    runner.run_test(test_integer_ideal, "Ideal over the integers test");
+    runner.run_test(test_fraction_free, "Fraction-free basis test");
+    return 0;
+}
@@ -0,0 +1,356 @@
+#include "framework/ut.h"
+
+#include "../fields/dynamic_modular.h"
+#include "../fields/modular.h"
+#include "../library/ideal.h"
+
+#include <atomic>
+#include <random>
+
+using namespace math;
+using namespace polynomial;
+
+template <class Compare>
+std::vector<Polynomial<Modular<101>, Compare>> get_cyclic(size_t n) {
+    std::vector<Polynomial<Modular<101>, Compare>> result;
+    for (size_t k = 1; k <= n; ++k) {
+        Polynomial<Modular<101>, Compare> polynomial;
+        for (size_t i = 0; i < n; ++i) {
+            std::vector<MonomialDegreeType> degree(n, 0);
+            for (size_t j = 0; j < k; ++j) {
+                degree[(i + j) % n] = 1;
+            }
+            polynomial.add(Monomial(std::move(degree)), 1);
+        }
+        result.push_back(std::move(polynomial));
+    }
+    result.back().subtract(Monomial(), 1);
+    return result;
+}
+
+template <class Compare>
+std::vector<Polynomial<Modular<101>, Compare>> get_random_system(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::vector<Polynomial<Modular<101>, Compare>> result(3);
+    for (auto& polynomial : result) {
+        for (size_t i = 0; i < 4; ++i) {
+            std::vector<MonomialDegreeType> degree(3);
+            for (auto& value : degree) {
+                value = generator() % 2;
+            }
+            polynomial.add(Monomial(std::move(degree)), generator() % 101);
+        }
+    }
+    return result;
+}
+
+template <class Compare>
+void check_strategies(std::vector<Polynomial<Modular<101>, Compare>> system) {
+    auto copy = system;
+    Ideal<Modular<101>, Compare> normal(std::move(copy));
+    Ideal<Modular<101>, Compare> sugar(std::move(system));
+    sugar.set_selection_strategy(SelectionStrategy::Sugar);
+    normal.make_groebner_basis();
+    sugar.make_groebner_basis();
+    assert_equal(normal.get_stats().strategy, SelectionStrategy::Normal, "normal strategy is reported");
+    assert_equal(sugar.get_stats().strategy, SelectionStrategy::Sugar, "sugar strategy is reported");
+    for (const auto& ideal : {normal, sugar}) {
+        const auto& stats = ideal.get_stats();
+        assert_equal(stats.pairs_reduced + stats.product_criterion + stats.chain_criterion, stats.pairs_created, "every created pair is reduced or pruned");
+        make_assert(stats.zero_reductions <= stats.pairs_reduced, "zero reductions are counted once");
+    }
+    make_assert(normal == sugar, "both strategies give the same basis");
+}
+
+void test_strategies() {
+    check_strategies(get_cyclic<GrevlexOrder>(4));
+    check_strategies(get_cyclic<LexOrder>(4));
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_strategies(get_random_system<LexOrder>(seed));
+        check_strategies(get_random_system<DeglexOrder>(seed));
+    }
+}
+
+template <class Compare>
+void check_s_polynomials(std::vector<Polynomial<Modular<101>, Compare>> system, GroebnerEngine engine = GroebnerEngine::Buchberger) {
+    Ideal<Modular<101>, Compare> ideal(std::move(system));
+    ideal.make_groebner_basis(engine);
+    const auto basis = ideal.get_basis();
+    for (size_t i = 0; i < basis.size(); ++i) {
+        for (size_t j = 0; j < i; ++j) {
+            const auto lcm = get_union(basis[i].get_major_monomial(), basis[j].get_major_monomial());
+            auto s_polynomial = basis[i] * (lcm / basis[i].get_major_monomial());
+            s_polynomial -= basis[j] * (lcm / basis[j].get_major_monomial());
+            make_assert(ideal.contains(s_polynomial), "every S-polynomial reduces to zero");
+        }
+    }
+}
+
+void test_criteria() {
+    Ideal<Modular<101>, GrevlexOrder> ideal(get_cyclic<GrevlexOrder>(5));
+    ideal.make_groebner_basis();
+    const auto& stats = ideal.get_stats();
+    make_assert(stats.product_criterion > 0, "product criterion prunes pairs");
+    make_assert(stats.chain_criterion > 0, "chain criterion prunes pairs");
+    check_s_polynomials(get_cyclic<GrevlexOrder>(4));
+    check_s_polynomials(get_cyclic<LexOrder>(4));
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_s_polynomials(get_random_system<LexOrder>(seed));
+        check_s_polynomials(get_random_system<GrevlexOrder>(seed));
+    }
+}
+
+template <class Compare>
+void check_engines(std::vector<Polynomial<Modular<101>, Compare>> system) {
+    auto copy = system;
+    Ideal<Modular<101>, Compare> buchberger(std::move(copy));
+    Ideal<Modular<101>, Compare> f4(std::move(system));
+    buchberger.make_minimal_groebner_basis(GroebnerEngine::Buchberger);
+    f4.make_minimal_groebner_basis(GroebnerEngine::F4);
+    assert_equal(f4.get_stats().engine, GroebnerEngine::F4, "F4 engine is reported");
+    make_assert(f4.get_stats().matrices > 0 || f4.get_stats().pairs_reduced == 0, "matrices are counted");
+    make_assert(buchberger == f4, "both engines give the same basis");
+}
+
+void test_f4() {
+    check_engines(get_cyclic<GrevlexOrder>(5));
+    check_engines(get_cyclic<LexOrder>(4));
+    check_s_polynomials(get_cyclic<GrevlexOrder>(4), GroebnerEngine::F4);
+    Ideal<Modular<101>, GrevlexOrder> sugar(get_cyclic<GrevlexOrder>(5));
+    sugar.set_selection_strategy(SelectionStrategy::Sugar);
+    sugar.make_minimal_groebner_basis(GroebnerEngine::F4);
+    Ideal<Modular<101>, GrevlexOrder> normal(get_cyclic<GrevlexOrder>(5));
+    make_assert(sugar == normal, "F4 with sugar selection");
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_engines(get_random_system<LexOrder>(seed));
+        check_engines(get_random_system<DeglexOrder>(seed));
+        check_s_polynomials(get_random_system<LexOrder>(seed), GroebnerEngine::F4);
+    }
+}
+
+void test_signature() {
+    Ideal<Modular<101>, GrevlexOrder> cyclic(get_cyclic<GrevlexOrder>(5));
+    cyclic.make_minimal_groebner_basis(GroebnerEngine::Signature);
+    const auto stats = cyclic.get_stats();
+    assert_equal(stats.engine, GroebnerEngine::Signature, "signature engine is reported");
+    make_assert(stats.avoided_reductions > 0, "reductions are avoided");
+    make_assert(stats.zero_reductions < stats.pairs_reduced / 2, "few reductions to zero");
+    Ideal<Modular<101>, GrevlexOrder> buchberger(get_cyclic<GrevlexOrder>(5));
+    make_assert(cyclic == buchberger, "signature and Buchberger bases are the same");
+    check_s_polynomials(get_cyclic<LexOrder>(4), GroebnerEngine::Signature);
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_s_polynomials(get_random_system<LexOrder>(seed), GroebnerEngine::Signature);
+        check_s_polynomials(get_random_system<GrevlexOrder>(seed), GroebnerEngine::Signature);
+        Ideal<Modular<101>, DeglexOrder> signature(get_random_system<DeglexOrder>(seed));
+        signature.make_minimal_groebner_basis(GroebnerEngine::Signature);
+        Ideal<Modular<101>, DeglexOrder> reference(get_random_system<DeglexOrder>(seed));
+        make_assert(signature == reference, "random system");
+    }
+}
+
+void test_thread_pool() {
+    ThreadPool pool(4);
+    assert_equal(pool.get_threads_count(), 4u, "threads count");
+    for (size_t count : {0, 1, 3, 1000}) {
+        std::vector<size_t> values(count, 0);
+        std::atomic<size_t> sum{0};
+        pool.parallel_for(count, [&values, &sum] (size_t i) {
+            values[i] = i * i;
+            sum += i;
+        });
+        for (size_t i = 0; i < count; ++i) {
+            assert_equal(values[i], i * i, "every task is run once");
+        }
+        assert_equal(sum.load(), count * (count - (count > 0 ? 1 : 0)) / 2, "sum of the indices");
+    }
+}
+
+template <class Compare>
+void check_parallel(std::vector<Polynomial<Modular<101>, Compare>> system) {
+    auto copy = system;
+    Ideal<Modular<101>, Compare> serial(std::move(copy));
+    Ideal<Modular<101>, Compare> parallel(std::move(system));
+    parallel.set_threads_count(4);
+    serial.make_minimal_groebner_basis();
+    parallel.make_minimal_groebner_basis();
+    assert_equal(parallel.get_stats().threads, 4u, "threads are reported");
+    make_assert(serial.get_basis() == parallel.get_basis(), "serial and parallel bases are the same");
+}
+
+void test_parallel() {
+    check_parallel(get_cyclic<GrevlexOrder>(5));
+    check_parallel(get_cyclic<LexOrder>(4));
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_parallel(get_random_system<LexOrder>(seed));
+        check_parallel(get_random_system<GrevlexOrder>(seed));
+    }
+}
+
+void test_divisibility_index() {
+    std::mt19937 generator(0);
+    auto get_random_monomial = [&generator] () {
+        std::vector<MonomialDegreeType> degree(generator() % 5);
+        for (auto& value : degree) {
+            value = generator() % 4;
+        }
+        return Monomial(std::move(degree));
+    };
+    std::vector<Monomial> monomials;
+    DivisibilityIndex<> index;
+    for (size_t i = 0; i < 300; ++i) {
+        monomials.push_back(get_random_monomial());
+        index.insert(monomials.back());
+    }
+    assert_equal(index.size(), monomials.size(), "index size");
+    for (size_t i = 0; i < 1000; ++i) {
+        const auto monomial = get_random_monomial();
+        size_t expected = DivisibilityIndex<>::NONE;
+        size_t expected_odd = DivisibilityIndex<>::NONE;
+        for (size_t j = monomials.size(); j > 0; --j) {
+            if (monomial.is_subset(monomials[j - 1])) {
+                expected = j - 1;
+                if (j % 2 == 0) {
+                    expected_odd = j - 1;
+                }
+            }
+        }
+        assert_equal(index.find_divisor(monomial), expected, "least divisor");
+        assert_equal(index.find_divisor(monomial, [] (size_t j) {
+            return j % 2 == 1;
+        }), expected_odd, "least divisor satisfying the predicate");
+    }
+    index.clear();
+    assert_equal(index.find_divisor(Monomial({1, 2})), DivisibilityIndex<>::NONE, "empty index");
+    index.insert(Monomial({0, 0}));
+    assert_equal(index.find_divisor(Monomial()), size_t(0), "trailing zeros are ignored");
+}
+
+void test_dynamic_modular() {
+    ModularContext context(101);
+    DynamicModular::ContextGuard guard(context);
+    for (size_t threads_count : {1, 4}) {
+        std::vector<Polynomial<DynamicModular, GrevlexOrder>> system;
+        for (const auto& polynomial : get_cyclic<GrevlexOrder>(5)) {
+            system.emplace_back();
+            for (const auto& term : polynomial) {
+                system.back().add(term.first, term.second.get_value());
+            }
+        }
+        Ideal<DynamicModular, GrevlexOrder> ideal(std::move(system));
+        ideal.set_threads_count(threads_count);
+        ideal.make_minimal_groebner_basis();
+        Ideal<Modular<101>, GrevlexOrder> reference(get_cyclic<GrevlexOrder>(5));
+        reference.make_minimal_groebner_basis();
+        const auto basis = ideal.get_basis();
+        const auto reference_basis = reference.get_basis();
+        assert_equal(basis.size(), reference_basis.size(), "basis size");
+        for (size_t i = 0; i < basis.size(); ++i) {
+            assert_equal(basis[i].get_terms_count(), reference_basis[i].get_terms_count(), "terms count");
+            auto term = basis[i].begin();
+            for (const auto& reference_term : reference_basis[i]) {
+                assert_equal(term->first, reference_term.first, "monomial");
+                assert_equal(term->second.get_value(), reference_term.second.get_value(), "coefficient");
+                ++term;
+            }
+        }
+    }
+}
+
+void test_pair_queue() {
+    PairQueue<GrevlexOrder> normal(SelectionStrategy::Normal);
+    PairQueue<GrevlexOrder> sugar(SelectionStrategy::Sugar);
+    for (auto* queue : {&normal, &sugar}) {
+        queue->push({1, 0, Monomial({2, 1}), 3});
+        queue->push({2, 0, Monomial({1, 1}), 5});
+        queue->push({2, 1, Monomial({0, 2}), 3});
+    }
+    assert_equal(normal.pop().lcm, Monomial({0, 2}), "ties of lcm degree are broken by the order");
+    assert_equal(normal.pop().lcm, Monomial({1, 1}), "lcm degree first");
+    assert_equal(normal.pop().lcm, Monomial({2, 1}), "greatest lcm last");
+    make_assert(normal.empty(), "queue is empty");
+    assert_equal(sugar.pop().lcm, Monomial({0, 2}), "lcm degree breaks sugar ties");
+    assert_equal(sugar.pop().lcm, Monomial({2, 1}), "sugar first");
+    assert_equal(sugar.size(), 1u, "one pair left");
+
+    PairQueue<GrevlexOrder> batch(SelectionStrategy::Normal);
+    batch.push({1, 0, Monomial({2, 1}), 3});
+    batch.push({2, 0, Monomial({1, 1}), 5});
+    batch.push({2, 1, Monomial({0, 2}), 3});
+    assert_equal(batch.pop_lowest_degree().size(), 2u, "both pairs of degree 2");
+    assert_equal(batch.pop_lowest_degree().size(), 1u, "the pair of degree 3");
+}
+
+template <class Compare>
+void check_incremental(std::vector<Polynomial<Modular<101>, Compare>> system, GroebnerEngine engine) {
+    Ideal<Modular<101>, Compare> incremental;
+    for (const auto& polynomial : system) {
+        incremental.add(polynomial);
+        incremental.make_groebner_basis(engine);
+    }
+    Ideal<Modular<101>, Compare> minimal;
+    for (const auto& polynomial : system) {
+        minimal.add(polynomial);
+        minimal.make_minimal_groebner_basis(engine);
+    }
+    Ideal<Modular<101>, Compare> reference(std::move(system));
+    make_assert(incremental == reference, "incremental basis");
+    make_assert(minimal == reference, "incremental basis from minimal bases");
+}
+
+void test_incremental() {
+    auto system = get_cyclic<GrevlexOrder>(5);
+    auto last = system.back();
+    system.pop_back();
+    Ideal<Modular<101>, GrevlexOrder> ideal(std::move(system));
+    ideal.make_groebner_basis();
+    const size_t installed = ideal.get_basis().size();
+    ideal.add(last);
+    ideal.make_groebner_basis();
+    assert_equal(ideal.get_stats().installed, installed, "the computed basis is installed");
+    Ideal<Modular<101>, GrevlexOrder> reference(get_cyclic<GrevlexOrder>(5));
+    reference.make_groebner_basis();
+    make_assert(ideal.get_stats().pairs_created < reference.get_stats().pairs_created, "old pairs are not created again");
+    make_assert(ideal == reference, "cyclic basis");
+
+    Ideal<Modular<101>, GrevlexOrder> sum(get_cyclic<GrevlexOrder>(4));
+    sum.make_minimal_groebner_basis();
+    sum += Ideal<Modular<101>, GrevlexOrder>({get_cyclic<GrevlexOrder>(5).back()});
+    sum.make_groebner_basis(GroebnerEngine::F4);
+    make_assert(sum.get_stats().installed > 0, "the minimal basis is installed");
+
+    check_incremental(get_cyclic<GrevlexOrder>(4), GroebnerEngine::Buchberger);
+    check_incremental(get_cyclic<LexOrder>(4), GroebnerEngine::F4);
+    check_incremental(get_cyclic<GrevlexOrder>(4), GroebnerEngine::Signature);
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_incremental(get_random_system<LexOrder>(seed), GroebnerEngine::Buchberger);
+        check_incremental(get_random_system<DeglexOrder>(seed), GroebnerEngine::F4);
+        check_incremental(get_random_system<GrevlexOrder>(seed), GroebnerEngine::Signature);
+    }
+}
+
+void test_basis_is_cached() {
+    Ideal<Modular<101>, GrevlexOrder> ideal(get_cyclic<GrevlexOrder>(4));
+    ideal.make_groebner_basis();
+    const auto basis = ideal.get_basis();
+    const auto pairs_reduced = ideal.get_stats().pairs_reduced;
+    make_assert(pairs_reduced > 0, "pairs are reduced");
+    ideal.make_groebner_basis();
+    make_assert(ideal.get_basis() == basis, "basis is not recomputed");
+    assert_equal(ideal.get_stats().pairs_reduced, pairs_reduced, "stats are kept");
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_strategies, "Selection strategies test");
+    runner.run_test(test_criteria, "Product and chain criteria test");
+    runner.run_test(test_f4, "F4 engine test");
+    runner.run_test(test_signature, "Signature engine test");
+    runner.run_test(test_thread_pool, "Thread pool test");
+    runner.run_test(test_parallel, "Parallel reduction test");
+    runner.run_test(test_divisibility_index, "Divisibility index test");
+    runner.run_test(test_dynamic_modular, "Runtime modulo field test");
+    runner.run_test(test_pair_queue, "Pair queue test");
+    runner.run_test(test_basis_is_cached, "Cached basis test");
+    runner.run_test(test_incremental, "Incremental basis test");
+    return 0;
+}
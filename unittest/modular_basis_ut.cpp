@@ -0,0 +1,127 @@
+#include "framework/ut.h"
+
+#include "../library/modular_basis.h"
+
+#include <random>
+
+using namespace math;
+using namespace polynomial;
+
+template <class Compare>
+using RationalPolynomial = Polynomial<Rational, Compare>;
+
+RationalType get_fraction(int numerator, int denominator) {
+    RationalType result(numerator);
+    result /= denominator;
+    return result;
+}
+
+template <class Compare>
+std::vector<RationalPolynomial<Compare>> get_random_system(unsigned seed) {
+    std::mt19937 generator(seed);
+    std::vector<RationalPolynomial<Compare>> result(3);
+    for (auto& polynomial : result) {
+        for (size_t i = 0; i < 4; ++i) {
+            std::vector<MonomialDegreeType> degree(3);
+            for (auto& value : degree) {
+                value = generator() % 2;
+            }
+            const int numerator = static_cast<int>(generator() % 41) - 20;
+            polynomial.add(Monomial(std::move(degree)), Rational(get_fraction(numerator, 1 + generator() % 7)));
+        }
+    }
+    return result;
+}
+
+template <class Compare, class ModularField = DynamicModular>
+void check_modular_basis(std::vector<RationalPolynomial<Compare>> system, size_t threads_count) {
+    auto copy = system;
+    Ideal<Rational, Compare> modular(std::move(copy));
+    Ideal<Rational, Compare> reference(std::move(system));
+    make_assert(make_modular_groebner_basis<ModularField>(modular, threads_count), "multi-modular algorithm succeeds");
+    reference.make_minimal_groebner_basis();
+    make_assert(modular.get_basis() == reference.get_basis(), "multi-modular basis is the reduced basis");
+}
+
+void test_reconstruct_rational() {
+    const ModularValueType first = get_previous_prime(MODULAR_BASIS_PRIMES_LIMIT);
+    const IntegerType modulus = IntegerType(first) * get_previous_prime(first);
+    IntegerType numerator;
+    IntegerType denominator;
+    for (int a : {0, 1, -1, 7, -12345, 99991}) {
+        for (int b : {1, 2, 3, 1000, 65521}) {
+            IntegerType value = IntegerType(a) % modulus;
+            IntegerType inverse;
+            mpz_invert(inverse.backend().data(), IntegerType(b).backend().data(), modulus.backend().data());
+            value = (value * inverse % modulus + modulus) % modulus;
+            make_assert(reconstruct_rational(value, modulus, numerator, denominator), "small fraction is reconstructed");
+            assert_equal(RationalType(numerator) / denominator, get_fraction(a, b), "reconstructed fraction");
+        }
+    }
+}
+
+void test_modular_basis() {
+    std::vector<RationalPolynomial<LexOrder>> system(2);
+    system[0].add(Monomial({2}), Rational(get_fraction(3, 7)));
+    system[0].add(Monomial({0, 1}), Rational(get_fraction(-5, 11)));
+    system[0].add(Monomial(), Rational(1));
+    system[1].add(Monomial({1, 1}), Rational(2));
+    system[1].add(Monomial({0, 0, 1}), Rational(get_fraction(13, 3)));
+    check_modular_basis(system, 1);
+    check_modular_basis(system, 3);
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_modular_basis(get_random_system<LexOrder>(seed), 2);
+        check_modular_basis(get_random_system<GrevlexOrder>(seed), 1);
+    }
+}
+
+void test_modular_basis64() {
+    for (unsigned seed = 0; seed < 20; ++seed) {
+        check_modular_basis<LexOrder, DynamicModular64>(get_random_system<LexOrder>(seed), 2);
+        check_modular_basis<GrevlexOrder, DynamicModular64>(get_random_system<GrevlexOrder>(seed), 1);
+    }
+    std::vector<RationalPolynomial<LexOrder>> system(2);
+    RationalType coefficient(1);
+    for (int i = 0; i < 4; ++i) {
+        coefficient *= 1000003;
+    }
+    system[0].add(Monomial({2}), Rational(coefficient + 1));
+    system[0].add(Monomial({0, 1}), Rational(get_fraction(-5, 11)));
+    system[1].add(Monomial({1, 1}), Rational(coefficient / 7));
+    system[1].add(Monomial({0, 0, 1}), Rational(1));
+    auto copy = system;
+    ModularBasis<LexOrder> basis(std::move(copy));
+    ModularBasis<LexOrder, MapTerms, DynamicModular64> basis64(std::move(system));
+    make_assert(basis.compute() && basis64.compute(), "multi-modular algorithm succeeds");
+    auto result = basis.release();
+    auto result64 = basis64.release();
+    make_assert(result.get_basis() == result64.get_basis(), "the same basis modulo 32-bit and 64-bit primes");
+    make_assert(basis64.get_primes_count() < basis.get_primes_count(), "fewer 64-bit primes");
+}
+
+void test_bad_prime() {
+    const ModularValueType first = get_previous_prime(MODULAR_BASIS_PRIMES_LIMIT);
+    std::vector<RationalPolynomial<GrevlexOrder>> system(2);
+    RationalType coefficient(1);
+    coefficient /= first;
+    system[0].add(Monomial({1, 1}), Rational(coefficient));
+    system[0].add(Monomial(), Rational(1));
+    system[1].add(Monomial({2}), Rational(1));
+    system[1].add(Monomial({0, 1}), Rational(get_previous_prime(first)));
+    auto copy = system;
+    ModularBasis<GrevlexOrder> basis(std::move(copy));
+    make_assert(basis.compute(), "bad primes are skipped");
+    assert_equal(basis.get_bad_primes_count(), 1u, "one bad prime");
+    Ideal<Rational, GrevlexOrder> reference(std::move(system));
+    auto result = basis.release();
+    make_assert(result == reference, "basis with a bad prime");
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_reconstruct_rational, "Rational reconstruction test");
+    runner.run_test(test_modular_basis, "Multi-modular basis test");
+    runner.run_test(test_bad_prime, "Bad prime test");
+    runner.run_test(test_modular_basis64, "Multi-modular basis with 64-bit primes test");
+    return 0;
+}
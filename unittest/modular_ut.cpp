@@ -1,6 +1,12 @@
 #include "framework/ut.h"
 
+#include "../fields/dynamic_modular.h"
+#include "../fields/dynamic_modular64.h"
 #include "../fields/modular.h"
+#include "../fields/row_kernels.h"
+
+#include <random>
+#include <vector>
 
 using namespace math;
 
@@ -39,9 +45,188 @@ void test_big_modulo() {
     make_assert((b * b).is_one(), "-1 * -1 == 1");
 }
 
+void test_primes() {
+    make_assert(!is_prime(0) && !is_prime(1) && is_prime(2) && is_prime(3) && !is_prime(91), "small numbers");
+    assert_equal(get_previous_prime(3), 2u, "prime before 3");
+    assert_equal(get_previous_prime(2), 0u, "no prime before 2");
+    assert_equal(get_previous_prime(1u << 31u), 2147483647u, "greatest prime below 2^31");
+    assert_equal(get_previous_prime(2147483647u), 2147483629u, "next prime");
+}
+
+template <ModularValueType modulo>
+void check_dynamic_modulo() {
+    ModularContext context(modulo);
+    DynamicModular::ContextGuard guard(context);
+    assert_equal(DynamicModular::get_modulo(), modulo, "modulo of the context");
+    std::mt19937 generator(modulo);
+    for (size_t i = 0; i < 1000; ++i) {
+        const ModularValueType first = generator() % modulo;
+        const ModularValueType second = generator() % modulo;
+        const DynamicModular a = first;
+        const DynamicModular b = second;
+        assert_equal((a + b).get_value(), (Modular<modulo>(first) + Modular<modulo>(second)).get_value(), "sum");
+        assert_equal((a - b).get_value(), (Modular<modulo>(first) - Modular<modulo>(second)).get_value(), "difference");
+        assert_equal((a * b).get_value(), (Modular<modulo>(first) * Modular<modulo>(second)).get_value(), "product");
+        if (second != 0) {
+            assert_equal((a / b).get_value(), (Modular<modulo>(first) / Modular<modulo>(second)).get_value(), "quotient");
+            assert_equal(a / b * b, a, "division check");
+        }
+    }
+}
+
+void test_dynamic_modulo() {
+    check_dynamic_modulo<2>();
+    check_dynamic_modulo<239>();
+    check_dynamic_modulo<MOD>();
+    check_dynamic_modulo<2147483647u>();
+    ModularContext outer(7);
+    ModularContext inner(11);
+    DynamicModular::ContextGuard outer_guard(outer);
+    {
+        DynamicModular::ContextGuard inner_guard(inner);
+        assert_equal(DynamicModular(10) + DynamicModular(3), DynamicModular(2), "inner context");
+    }
+    assert_equal(DynamicModular(5) + DynamicModular(3), DynamicModular(1), "outer context is restored");
+    assert_equal(DynamicModular(3) * DynamicModular(5), DynamicModular(1), "3 * 5 == 1 (modulo 7)");
+}
+
+void check_dynamic_modulo64(ModularValueType64 modulo) {
+    ModularContext64 context(modulo);
+    DynamicModular64::ContextGuard guard(context);
+    assert_equal(DynamicModular64::get_modulo(), modulo, "modulo of the context");
+    make_assert(DynamicModular64(1).is_one() && DynamicModular64(0).is_zero(), "one and zero");
+    std::mt19937_64 generator(modulo);
+    for (size_t i = 0; i < 1000; ++i) {
+        const ModularValueType64 first = i % 10 ? generator() % modulo : modulo - 1;
+        const ModularValueType64 second = i % 7 ? generator() % modulo : modulo - 1;
+        const DynamicModular64 a = first;
+        const DynamicModular64 b = second;
+        assert_equal(a.get_value(), first, "value");
+        assert_equal((a + b).get_value(), static_cast<ModularValueType64>((static_cast<ModularValueType128>(first) + second) % modulo), "sum");
+        assert_equal((a - b).get_value(), static_cast<ModularValueType64>((static_cast<ModularValueType128>(first) + modulo - second) % modulo), "difference");
+        assert_equal((a * b).get_value(), multiply_modulo(first, second, modulo), "product");
+        if (second != 0) {
+            assert_equal(a / b * b, a, "division check");
+        }
+    }
+}
+
+void test_dynamic_modulo64() {
+    make_assert(!is_prime64(0) && !is_prime64(1) && is_prime64(2) && is_prime64(37) && !is_prime64(91), "small numbers");
+    make_assert(!is_prime64(3215031751u) && !is_prime64(3825123056546413051u), "strong pseudoprimes");
+    assert_equal(get_previous_prime64(ModularValueType64(1) << 63u), 9223372036854775783u, "greatest prime below 2^63");
+    assert_equal(get_previous_prime64(ModularValueType64(1) << 61u), (ModularValueType64(1) << 61u) - 1, "Mersenne prime 2^61 - 1");
+    check_dynamic_modulo64(3);
+    check_dynamic_modulo64(MOD);
+    check_dynamic_modulo64((ModularValueType64(1) << 61u) - 1);
+    check_dynamic_modulo64(9223372036854775783u);
+}
+
+template <ModularValueType modulo>
+void check_accumulator() {
+    ModularContext context(modulo);
+    DynamicModular::ContextGuard guard(context);
+    std::mt19937 generator(modulo);
+    Modular<modulo> expected = generator() % modulo;
+    ModularAccumulator<modulo> sum = expected;
+    DynamicModularAccumulator dynamic_sum = DynamicModular(expected.get_value());
+    for (size_t i = 0; i < 100000; ++i) {
+        const Modular<modulo> first = i % 2 ? generator() % modulo : modulo - 1;
+        const Modular<modulo> second = i % 2 ? generator() % modulo : modulo - 1;
+        expected += first * second;
+        sum.add_product(first, second);
+        dynamic_sum.add_product(first.get_value(), second.get_value());
+    }
+    assert_equal(sum.get(), expected, "sum of products");
+    assert_equal(dynamic_sum.get().get_value(), expected.get_value(), "sum of products (runtime modulo)");
+}
+
+void test_inverse() {
+    for (ModularValueType i = 1; i < 239; ++i) {
+        assert_equal(Modular<239>(i) / Modular<239>(i), Modular<239>(1), "table inverse");
+        assert_equal(Modular<2147483647u>(i) / Modular<2147483647u>(i), Modular<2147483647u>(1), "inverse");
+    }
+    check_accumulator<2>();
+    check_accumulator<239>();
+    check_accumulator<MOD>();
+    check_accumulator<2147483647u>();
+}
+
+template <ModularValueType modulo>
+void check_row_kernels(RowKernels kernels) {
+    std::mt19937 generator(modulo);
+    for (size_t size : {0, 1, 7, 8, 9, 100, 1027}) {
+        std::vector<ModularValueType> row(size);
+        std::vector<ModularValueType> pivot(size);
+        std::vector<Modular<modulo>> expected(size);
+        for (size_t i = 0; i < size; ++i) {
+            row[i] = i % 3 ? generator() % modulo : modulo - 1;
+            pivot[i] = i % 5 ? generator() % modulo : modulo - 1;
+        }
+        for (ModularValueType factor : {0u, 1u, modulo - 1, static_cast<ModularValueType>(generator() % modulo)}) {
+            for (size_t i = 0; i < size; ++i) {
+                expected[i] = Modular<modulo>(row[i]) - Modular<modulo>(factor) * Modular<modulo>(pivot[i]);
+            }
+            subtract_scaled_row(row.data(), pivot.data(), size, factor, modulo, kernels);
+            for (size_t i = 0; i < size; ++i) {
+                assert_equal(row[i], expected[i].get_value(), "scaled subtraction");
+                expected[i] *= Modular<modulo>(factor);
+            }
+            scale_row(row.data(), size, factor, modulo, kernels);
+            for (size_t i = 0; i < size; ++i) {
+                assert_equal(row[i], expected[i].get_value(), "scaling");
+            }
+            if (factor == 0) {
+                for (size_t i = 0; i < size; ++i) {
+                    row[i] = generator() % modulo;
+                }
+            }
+        }
+        std::vector<uint32_t> columns;
+        std::vector<ModularValueType> values;
+        for (size_t i = 0; i < size; ++i) {
+            if (generator() % 2) {
+                columns.push_back(static_cast<uint32_t>(i));
+                values.push_back(i % 2 ? generator() % modulo : modulo - 1);
+            }
+        }
+        std::vector<ModularValueType64> sums(size, 0);
+        std::vector<Modular<modulo>> sums_expected(size);
+        for (size_t round = 0; round < 100; ++round) {
+            const ModularValueType factor = round % 2 ? generator() % modulo : modulo - 1;
+            add_scaled_sparse_row(sums.data(), columns.data(), values.data(), columns.size(), factor, (ModularValueType64(1) << 63u) / modulo * modulo, kernels);
+            for (size_t i = 0; i < columns.size(); ++i) {
+                sums_expected[columns[i]] += Modular<modulo>(factor) * Modular<modulo>(values[i]);
+            }
+        }
+        for (size_t i = 0; i < size; ++i) {
+            make_assert(sums[i] < (ModularValueType64(1) << 63u), "sums are less than 2^63");
+            assert_equal(static_cast<ModularValueType>(sums[i] % modulo), sums_expected[i].get_value(), "sparse row sums");
+        }
+    }
+}
+
+void test_row_kernels() {
+    std::vector<RowKernels> kernels = {RowKernels::Scalar};
+    if (get_row_kernels() != RowKernels::Scalar) {
+        kernels.push_back(get_row_kernels());
+    }
+    for (RowKernels current : kernels) {
+        check_row_kernels<2>(current);
+        check_row_kernels<239>(current);
+        check_row_kernels<MOD>(current);
+        check_row_kernels<2147483647u>(current);
+    }
+}
+
 int main() {
     TestRunner runner;
     runner.run_test(test_modulo_2, "Modulo 2 test");
     runner.run_test(test_big_modulo, "Big modulo (10^9+7) test");
+    runner.run_test(test_primes, "Primes test");
+    runner.run_test(test_dynamic_modulo, "Runtime modulo test");
+    runner.run_test(test_dynamic_modulo64, "Runtime 64-bit modulo test");
+    runner.run_test(test_inverse, "Inverse and accumulator test");
+    runner.run_test(test_row_kernels, "Row kernels test");
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,86 @@
+#include "framework/ut.h"
+
+#include "../library/monomial.h"
+
+#include <sstream>
+
+using namespace polynomial;
+
+void test_packed_arithmetic() {
+    Monomial a({1, 2, 0, 3});
+    Monomial b({0, 1, 4});
+    make_assert(a.is_packed() && b.is_packed(), "small monomials are packed");
+    assert_equal(a * b, Monomial({1, 3, 4, 3}), "multiplication");
+    assert_equal(a * b / b, a, "division");
+    assert_equal(get_intersection(a, b), Monomial({0, 1}), "intersection");
+    make_assert((a * b).is_subset(a), "product is divisible by a factor");
+    make_assert(!a.is_subset(b), "a is not divisible by b");
+    assert_equal(Monomial({1, 0, 0}).size(), 1u, "trailing zeros are trimmed");
+    make_assert(Monomial({0, 0}).is_empty(), "zero degrees give an empty monomial");
+}
+
+void test_promotion() {
+    Monomial a({MONOMIAL_PACKED_LIMIT, 1});
+    Monomial b({1});
+    make_assert(a.is_packed(), "limit degree is still packed");
+    Monomial c = a * b;
+    make_assert(!c.is_packed(), "overflow promotes to wide storage");
+    assert_equal(c.get_degree(0), MONOMIAL_PACKED_LIMIT + 1, "promoted degree");
+    assert_equal(c.get_degree(1), 1u, "promoted degree of the other variable");
+    make_assert((c / b).is_packed(), "division demotes back to packed storage");
+    assert_equal(c / b, a, "division of promoted monomial");
+
+    std::vector<MonomialDegreeType> degree(MONOMIAL_PACKED_CAPACITY + 1, 1);
+    Monomial long_monomial(std::move(degree));
+    make_assert(!long_monomial.is_packed(), "too many variables promote to wide storage");
+    Monomial copy = long_monomial;
+    assert_equal(copy, long_monomial, "copy of wide monomial");
+    make_assert(long_monomial.is_subset(Monomial({1, 1})), "wide is divisible by packed");
+    assert_equal(get_intersection(long_monomial, Monomial({3, 0, 2})), Monomial({1, 0, 1}), "mixed intersection");
+    make_assert(Monomial({1, 1}) < long_monomial, "mixed comparison");
+}
+
+void test_order() {
+    make_assert(Monomial({0, 1}) < Monomial({1}), "x_1 < x_0");
+    make_assert(Monomial({1}) < Monomial({1, 1}), "x_0 < x_0*x_1");
+    make_assert(!(Monomial({2}) < Monomial({2})), "irreflexive");
+    make_assert(Monomial() < Monomial({0, 0, 1}), "1 < x_2");
+}
+
+void test_cache() {
+    Monomial a({1, 2, 0, 9});
+    assert_equal(a.get_total_degree(), 12u, "total degree");
+    assert_equal(a.get_mask(), MonomialMaskType(0xf031), "divisibility mask");
+    assert_equal((a * a).get_total_degree(), 24u, "total degree of product");
+    assert_equal((a / Monomial({1, 1})).get_total_degree(), 10u, "total degree of quotient");
+    make_assert((a * Monomial({0, 0, 1})).get_mask() == (a.get_mask() | get_degree_mask(2, 1)), "mask of product");
+    make_assert(!a.is_subset(Monomial({0, 4})), "rejected by mask");
+    make_assert(!a.is_subset(Monomial({13})), "rejected by total degree");
+    make_assert(a.is_subset(Monomial({1, 2, 0, 9})), "divisible by itself");
+    make_assert(get_intersection(Monomial({1}), Monomial({0, 1})).is_empty(), "coprime intersection");
+
+    std::vector<MonomialDegreeType> degree(MONOMIAL_MASK_VARIABLES + 1, 0);
+    degree[MONOMIAL_MASK_VARIABLES] = 1;
+    Monomial folded(std::move(degree));
+    assert_equal(folded.get_mask(), Monomial({1}).get_mask(), "masks of far variables are folded");
+    make_assert(!Monomial({1}).is_subset(folded), "folded mask doesn't break divisibility");
+}
+
+void test_variable_names() {
+    const std::deque<std::string> names = {"a", "b1"};
+    std::ostringstream out;
+    out << Monomial({1, 2, 0, 3}) << " ";
+    out << VariableNames{&names} << Monomial({1, 2, 0, 3}) << " " << Monomial() << " ";
+    out << VariableNames{} << Monomial({0, 1});
+    assert_equal(out.str(), std::string("x_0*x_1^2*x_3^3 a*b1^2*x_3^3 1 x_1"), "names of the variables");
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_packed_arithmetic, "Packed monomial arithmetic test");
+    runner.run_test(test_promotion, "Monomial promotion test");
+    runner.run_test(test_order, "Monomial lexicographic order test");
+    runner.run_test(test_cache, "Monomial degree and mask cache test");
+    runner.run_test(test_variable_names, "Monomial variable names test");
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include "framework/ut.h"
+
+#include "../fields/modular.h"
+#include "../library/ideal.h"
+#include "../library/order.h"
+
+using namespace math;
+using namespace polynomial;
+
+void test_lex() {
+    LexOrder cmp;
+    make_assert(cmp(Monomial({0, 5}), Monomial({1})), "x_1^5 < x_0");
+    make_assert(!cmp(Monomial({1}), Monomial({1})), "irreflexive");
+}
+
+void test_deglex() {
+    DeglexOrder cmp;
+    make_assert(cmp(Monomial({1}), Monomial({0, 2})), "x_0 < x_1^2");
+    make_assert(cmp(Monomial({0, 2}), Monomial({1, 1})), "x_1^2 < x_0*x_1");
+    make_assert(cmp(Monomial({1, 0, 1}), Monomial({1, 1})), "x_0*x_2 < x_0*x_1");
+}
+
+void test_grevlex() {
+    GrevlexOrder cmp;
+    make_assert(cmp(Monomial({1}), Monomial({0, 2})), "x_0 < x_1^2");
+    make_assert(cmp(Monomial({1, 0, 1}), Monomial({0, 2})), "x_0*x_2 < x_1^2");
+    make_assert(!cmp(Monomial({0, 2}), Monomial({1, 0, 1})), "x_1^2 > x_0*x_2");
+    make_assert(cmp(Monomial({0, 1, 1}), Monomial({2})), "x_1*x_2 < x_0^2");
+    assert_equal(GrevlexOrder::compare(Monomial({1, 0, 1}), Monomial({0, 2}), 0, ORDER_ALL_VARIABLES), -1, "three-way");
+    assert_equal(GrevlexOrder::compare(Monomial({3, 0, 1}), Monomial({0, 2, 1}), 2, 3), 0, "restricted range");
+}
+
+void test_weighted_and_block() {
+    WeightedOrder<1, 3> weighted;
+    make_assert(weighted(Monomial({2}), Monomial({0, 1})), "x_0^2 < x_1 with weights (1, 3)");
+    make_assert(weighted(Monomial({0, 0, 2}), Monomial({1, 0, 1})), "ties are broken by grevlex");
+
+    BlockOrder<1> block;
+    make_assert(block(Monomial({0, 5, 5}), Monomial({1})), "x_0 is eliminated");
+    make_assert(block(Monomial({1, 0, 2}), Monomial({1, 1, 1})), "second block is grevlex");
+    BlockOrder<1, LexOrder, BlockOrder<1, LexOrder, DeglexOrder>> nested;
+    make_assert(nested(Monomial({0, 1}), Monomial({1})), "nested first block");
+    make_assert(nested(Monomial({0, 0, 3}), Monomial({0, 1})), "nested second block");
+    make_assert(nested(Monomial({0, 1, 0, 1}), Monomial({0, 1, 2})), "nested third block");
+}
+
+template <class Compare>
+void check_ideal_membership() {
+    using PolynomialType = Polynomial<Modular<101>, Compare>;
+    PolynomialType f({{Monomial({2}), 1}, {Monomial({0, 1}), 100}});
+    PolynomialType g({{Monomial({1, 1}), 1}, {Monomial({0, 0, 1}), 100}});
+    Ideal<Modular<101>, Compare> ideal({f, g});
+    make_assert(ideal.contains(f * g + g * Monomial({0, 3}) * 7), "combination of generators");
+    make_assert(!ideal.contains(PolynomialType(Monomial({1}), 1)), "x_0 is not in the ideal");
+}
+
+void test_ideal_orders() {
+    check_ideal_membership<LexOrder>();
+    check_ideal_membership<DeglexOrder>();
+    check_ideal_membership<GrevlexOrder>();
+    check_ideal_membership<WeightedOrder<2, 1, 1>>();
+    check_ideal_membership<BlockOrder<1>>();
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_lex, "Lex order test");
+    runner.run_test(test_deglex, "Deglex order test");
+    runner.run_test(test_grevlex, "Grevlex order test");
+    runner.run_test(test_weighted_and_block, "Weighted and block orders test");
+    runner.run_test(test_ideal_orders, "Ideal membership for all orders test");
+    return 0;
+}
@@ -0,0 +1,203 @@
+#include "framework/ut.h"
+
+#include "../fields/boolean.h"
+#include "../fields/modular.h"
+#include "../parser/io.h"
+#include "../parser/loader.h"
+
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace math;
+using namespace parser;
+using namespace polynomial;
+
+template <class T>
+std::string to_string(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+void test_rational() {
+    Polynomial<Rational> expected;
+    expected.add(Monomial({2, 1}), 1);
+    expected.add(Monomial({1, 0, 1}), 1);
+    expected.add(Monomial({0, 2, 1}), 1);
+    make_assert(parse_polynomial("x_0^2*x_1+x_0*x_2+x_1^2*x_2") == expected, "plain input");
+    make_assert(parse_polynomial("  x_0 ^ 2 * x_1\t+ x_0*x_2 +x_1^2 *x_2 ") == expected, "spaces");
+    make_assert(parse_polynomial("x_1^2*x_2+x_0*x_2+x_1*x_0*x_0") == expected, "order of the terms and the variables");
+
+    Polynomial<Rational> coefficients;
+    coefficients.add(Monomial({1}), Rational(3) / Rational(4));
+    coefficients.add(Monomial({0, 3}), -2);
+    coefficients.add(Monomial(), 7);
+    make_assert(parse_polynomial("3/4*x_0 - 2*x_1^3 + 7") == coefficients, "coefficients");
+    make_assert(parse_polynomial("-2*x_1^3+x_0*6/8+14/2") == coefficients, "leading minus and fractions");
+    make_assert(parse_polynomial("x_0*2*3*x_0") == Polynomial<Rational>(Monomial({2}), 6), "products of factors");
+    make_assert(parse_polynomial("x_0 - x_0 + 0*x_1").is_zero(), "cancellation");
+    make_assert(parse_polynomial(" ").is_zero(), "empty input");
+    make_assert(parse_term("5*x_2") == Polynomial<Rational>(Monomial({0, 0, 1}), 5), "term");
+    assert_equal(parse_coefficient(std::string("22/6"), 0, 4), Rational(11) / Rational(3), "coefficient");
+    const Rational big = math::RationalType("31415926535897932384626");
+    make_assert(parse_polynomial("31415926535897932384626*x_1") == Polynomial<Rational>(Monomial({0, 1}), big), "big coefficient");
+}
+
+void test_monomial() {
+    assert_equal(parse_monomial("x_0^2*x_3"), Monomial({2, 0, 0, 1}), "monomial");
+    assert_equal(parse_monomial("x_1*x_1"), Monomial({0, 2}), "repeated variable");
+    assert_equal(parse_monomial(""), Monomial(), "empty monomial");
+    assert_equal(parse_monomial<Boolean>("x_1^3*x_2*x_1"), BooleanMonomial({0, 1, 1}), "boolean monomial");
+}
+
+void test_fields() {
+    using ModularPolynomial = Polynomial<Modular<101>, GrevlexOrder, VectorTerms>;
+    ModularPolynomial expected;
+    expected.add(Monomial({1}), 48);
+    expected.add(Monomial({0, 1}), 34);
+    expected.add(Monomial(), 52);
+    make_assert(parse_polynomial<Modular<101>, GrevlexOrder, VectorTerms>("250*x_0+31415926535897932384626*x_1+3/2") == expected, "modulo 101");
+    make_assert(parse_polynomial<Modular<101>, GrevlexOrder, VectorTerms>("x_0*101+1-102").is_zero(), "zero modulo 101");
+
+    Polynomial<Boolean> boolean;
+    boolean.add(BooleanMonomial({0, 0, 1}), 1);
+    make_assert(parse_polynomial<Boolean>("x_0*x_0*x_1 + 3*x_1*x_0 + x_2") == boolean, "boolean");
+    make_assert(parse_polynomial<Boolean, LexOrder, BooleanTerms>("x_0 + x_0 + 2*x_1").is_zero(), "boolean terms");
+}
+
+void test_round_trip() {
+    std::mt19937 generator(0);
+    for (size_t i = 0; i < 100; ++i) {
+        Polynomial<Rational, GrevlexOrder> polynomial;
+        for (size_t j = 0; j < 10; ++j) {
+            std::vector<MonomialDegreeType> degree(4);
+            for (auto& value : degree) {
+                value = generator() % 4;
+            }
+            const Rational coefficient = Rational(static_cast<int64_t>(generator() % 2000) - 1000) / Rational(1 + generator() % 1000);
+            polynomial.add(Monomial(std::move(degree)), i % 2 == 0 ? coefficient : coefficient * Rational(1ull << 62u) * Rational(1ull << 62u));
+        }
+        const auto parsed = parse_polynomial<Rational, GrevlexOrder>(to_string(polynomial));
+        make_assert(parsed == polynomial, "printed polynomial is parsed back");
+    }
+    make_assert(parse_polynomial("x_0+(-2)*x_1") == parse_polynomial("x_0-2*x_1"), "negative coefficient");
+    make_assert(parse_polynomial("(-1/3)*x_1+(-5)") == parse_polynomial("-1/3*x_1-5"), "negative fraction");
+    make_assert(parse_polynomial<Modular<7>>("( - 2 )*x_0*(+3/2)") == parse_polynomial<Modular<7>>("4*x_0"), "signs in the parentheses");
+}
+
+void test_io() {
+    std::istringstream in("x_0^2-x_1 3*x_1+1/2\nx_0^3*x_2");
+    Polynomial<Rational> first;
+    Polynomial<Modular<7>, LexOrder> second;
+    Monomial monomial;
+    in >> first >> second >> monomial;
+    make_assert(first == parse_polynomial("x_0^2-x_1"), "first polynomial");
+    make_assert(second == parse_polynomial<Modular<7>, LexOrder>("3*x_1+4"), "second polynomial");
+    assert_equal(monomial, Monomial({3, 0, 1}), "monomial");
+}
+
+void test_loader() {
+    std::mt19937 generator(1);
+    std::vector<std::string> sources;
+    std::string input;
+    for (size_t i = 0; i < 200; ++i) {
+        std::string source;
+        for (size_t j = 0; j < 1 + generator() % 6; ++j) {
+            source += (j == 0 ? "" : generator() % 2 == 0 ? " + " : "-") + std::to_string(generator() % 1000);
+            source += "*x_" + std::to_string(generator() % 5) + "^" + std::to_string(generator() % 3);
+        }
+        sources.push_back(source);
+        input += source + (i % 3 == 0 ? ";" : "\n") + (i % 7 == 0 ? "\n  \n" : "");
+    }
+    const std::string path = "parser_ut_input.txt";
+    std::ofstream(path) << input;
+    for (size_t threads_count = 1; threads_count <= 3; threads_count += 2) {
+        IdealLoader<Modular<101>, GrevlexOrder> file_loader(threads_count);
+        make_assert(file_loader.load_file(path), "file is loaded");
+        std::istringstream in(input);
+        IdealLoader<Modular<101>, GrevlexOrder> stream_loader(threads_count, 7);
+        make_assert(stream_loader.load_stream(in), "stream is loaded");
+        assert_equal(file_loader.get_stats().polynomials, sources.size(), "polynomials count");
+        assert_equal(stream_loader.get_stats().bytes, input.size(), "bytes count");
+        Ideal<Modular<101>, GrevlexOrder> expected;
+        for (const auto& source : sources) {
+            expected.add(parse_polynomial<Modular<101>, GrevlexOrder>(source));
+        }
+        auto from_file = file_loader.release();
+        auto from_stream = stream_loader.release();
+        make_assert(from_file.get_basis() == expected.get_basis() && from_stream.get_basis() == expected.get_basis(), "polynomials in order");
+    }
+    std::remove(path.c_str());
+    IdealLoader<> loader;
+    make_assert(!loader.load_file(path), "missing file");
+}
+
+void test_symbols() {
+    SymbolTable symbols;
+    const auto first = parse_polynomial("theta_3^2*a - 2*b1 + a*a", symbols);
+    assert_equal(symbols.size(), size_t(3), "three names");
+    assert_equal(symbols.find("a"), size_t(1), "numbered by the first appearance");
+    assert_equal(symbols.find("c"), SymbolTable::NONE, "unknown name");
+    make_assert(first == parse_polynomial("x_0^2*x_1-2*x_2+x_1^2"), "same polynomial with x_i");
+    const auto second = parse_polynomial("c*theta_3 + 1/2", symbols);
+    assert_equal(symbols.get_name(3), std::string("c"), "the table is shared");
+    make_assert(second == parse_polynomial("x_3*x_0+1/2"), "second polynomial");
+    assert_equal(parse_monomial("b1^2*c", symbols), Monomial({0, 0, 2, 1}), "named monomial");
+
+    std::ostringstream out;
+    out << symbols.get_variable_names() << first << ", " << second;
+    assert_equal(out.str(), std::string("theta_3^2*a+a^2+(-2)*b1, theta_3*c+1/2"), "printed with the names");
+    SymbolTable copy = symbols;
+    make_assert(parse_polynomial(out.str().substr(0, out.str().find(',')), copy) == first && copy.size() == symbols.size(), "round trip");
+
+    const auto negative = parse_polynomial("-1/3*theta_3*c - 5 + (-2)*a^2", symbols);
+    out.str("");
+    out << symbols.get_variable_names() << negative;
+    make_assert(parse_polynomial(out.str(), symbols) == negative, "round trip of negative coefficients");
+    const SymbolTable& known = symbols;
+    make_assert(PolynomialParser<>(out.str(), 0, out.str().size(), &known).parse_polynomial() == negative, "read-only table");
+    assert_equal(symbols.size(), size_t(4), "no new names");
+
+    SymbolTable ordered({"z", "y", "x"});
+    make_assert(parse_polynomial<Modular<7>, LexOrder>("x + y*z", ordered) == parse_polynomial<Modular<7>, LexOrder>("x_2+x_0*x_1"), "names given in advance");
+    out.str("");
+    out << ordered.get_variable_names() << parse_polynomial<Boolean>("x*z + y + x_5", ordered);
+    assert_equal(out.str(), std::string("z*x+y+x_5"), "boolean polynomial with the names");
+
+    std::string input;
+    for (size_t i = 0; i < 300; ++i) {
+        input += "v" + std::to_string(i * 7 % 100) + "*alpha - 3*w" + std::to_string(i % 13) + "^2\n";
+    }
+    SymbolTable serial;
+    std::vector<Polynomial<Modular<101>>> expected;
+    for (size_t from = 0, to = input.find('\n'); to != std::string::npos; from = to + 1, to = input.find('\n', from)) {
+        expected.push_back(parse_polynomial<Modular<101>>(input.substr(from, to - from), serial));
+    }
+    for (size_t threads_count = 1; threads_count <= 3; threads_count += 2) {
+        SymbolTable shared;
+        std::istringstream in(input);
+        IdealLoader<Modular<101>> loader(threads_count, 100);
+        loader.set_symbol_table(&shared);
+        make_assert(loader.load_stream(in), "stream is loaded");
+        make_assert(loader.release().get_basis() == Ideal<Modular<101>>(std::vector<Polynomial<Modular<101>>>(expected)).get_basis(), "loaded with the names");
+        assert_equal(shared.size(), serial.size(), "names count");
+        for (size_t i = 0; i < serial.size(); ++i) {
+            assert_equal(shared.get_name(i), serial.get_name(i), "the numbering doesn't depend on the threads");
+        }
+    }
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_rational, "Rational parser test");
+    runner.run_test(test_monomial, "Monomial parser test");
+    runner.run_test(test_fields, "Field parser test");
+    runner.run_test(test_round_trip, "Round trip test");
+    runner.run_test(test_io, "Input test");
+    runner.run_test(test_loader, "Loader test");
+    runner.run_test(test_symbols, "Symbol table test");
+    return 0;
+}
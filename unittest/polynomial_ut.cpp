@@ -0,0 +1,163 @@
+#include "framework/ut.h"
+
+#include "../fields/modular.h"
+#include "../library/polynomial.h"
+
+#include <random>
+#include <sstream>
+#include <string>
+
+using namespace math;
+using namespace polynomial;
+
+using FieldType = Modular<101>;
+
+template <template <class, class> class Terms>
+using PolynomialType = Polynomial<FieldType, GrevlexOrder, Terms>;
+
+template <class T>
+std::string to_string(const T& value) {
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+template <template <class, class> class Terms>
+PolynomialType<Terms> get_random_polynomial(std::mt19937& generator, size_t terms_count) {
+    PolynomialType<Terms> result;
+    for (size_t i = 0; i < terms_count; ++i) {
+        std::vector<MonomialDegreeType> degree(3);
+        for (auto& value : degree) {
+            value = generator() % 3;
+        }
+        result.add(Monomial(std::move(degree)), FieldType(generator() % 101));
+    }
+    return result;
+}
+
+template <template <class, class> class Terms>
+std::vector<std::string> run_operations(unsigned seed) {
+    std::mt19937 generator(seed);
+    const auto a = get_random_polynomial<Terms>(generator, 12);
+    const auto b = get_random_polynomial<Terms>(generator, 9);
+    const Monomial m({1, 0, 2});
+    std::vector<std::string> result;
+    result.push_back(to_string(a + b));
+    result.push_back(to_string(a - b));
+    result.push_back(to_string(a - a));
+    result.push_back(to_string(a * b));
+    result.push_back(to_string(a * m * FieldType(7)));
+    result.push_back(to_string((a * m) / m));
+    result.push_back(to_string(a / FieldType(3)));
+    auto c = a * b + b;
+    if (!b.is_zero()) {
+        b.reduce(c);
+    }
+    result.push_back(to_string(c));
+    auto d = a * b + a;
+    if (!b.is_zero()) {
+        b.full_reduce(d);
+    }
+    result.push_back(to_string(d));
+    auto e = a;
+    e.subtract_multiple(b, m, FieldType(5));
+    assert_equal(e, a - b * m * FieldType(5), "subtract multiple");
+    result.push_back(to_string(e));
+    if (!b.is_zero()) {
+        auto f = a;
+        f.subtract_multiple(b, m, FieldType(5), true);
+        assert_equal(f, a - (b - b.get_major_term()) * m * FieldType(5), "subtract multiple without the major term");
+        result.push_back(to_string(f));
+    }
+    e.subtract_multiple(e, m, FieldType(1));
+    assert_equal(e, (a - b * m * FieldType(5)) * (PolynomialType<Terms>(Monomial(), 1) - PolynomialType<Terms>(m, 1)), "subtract multiple of itself");
+    return result;
+}
+
+void test_storages_agree() {
+    for (unsigned seed = 0; seed < 50; ++seed) {
+        const auto map_result = run_operations<MapTerms>(seed);
+        const auto vector_result = run_operations<VectorTerms>(seed);
+        for (size_t i = 0; i < map_result.size(); ++i) {
+            assert_equal(map_result[i], vector_result[i], "operation " + std::to_string(i) + ", seed " + std::to_string(seed));
+        }
+    }
+}
+
+template <template <class, class> class Terms>
+void check_arithmetic() {
+    PolynomialType<Terms> x(Monomial({1}), 1);
+    PolynomialType<Terms> y(Monomial({0, 1}), 1);
+    PolynomialType<Terms> one(Monomial(), 1);
+    const auto square = (x + y) * (x + y);
+    assert_equal(square, x * x + x * y * FieldType(2) + y * y, "square of sum");
+    assert_equal(square.get_terms_count(), 3u, "terms count");
+    assert_equal(square.get_major_monomial(), Monomial({2}), "major monomial");
+    make_assert((square - square).is_zero(), "difference with itself");
+    auto z = x;
+    z.subtract(Monomial({1}), 1);
+    make_assert(z.is_zero(), "subtract the only term");
+    z.add(Monomial(), 5);
+    make_assert(z.is_constant(), "constant polynomial");
+    assert_equal(to_string(x - one), "x_0+[100 (modulo 101)]", "printing");
+}
+
+void test_arithmetic() {
+    check_arithmetic<MapTerms>();
+    check_arithmetic<VectorTerms>();
+}
+
+template <template <class, class> class Terms>
+void check_geobucket() {
+    std::mt19937 generator(239);
+    PolynomialType<Terms> sum;
+    Geobucket<PolynomialType<Terms>> bucket;
+    for (size_t i = 0; i < 200; ++i) {
+        auto summand = get_random_polynomial<Terms>(generator, 1 + i % 13);
+        sum += summand;
+        bucket.add(std::move(summand));
+        if (i % 17 == 0) {
+            make_assert(!bucket.is_zero(), "the sum is not zero");
+            assert_equal(bucket.get_major_monomial(), sum.get_major_monomial(), "major monomial");
+            assert_equal(bucket.get_major_coefficient(), sum.get_major_coefficient(), "major coefficient");
+        }
+    }
+    bucket.add(sum * FieldType(100));
+    make_assert(bucket.is_zero(), "the sum cancels");
+    make_assert(bucket.release().is_zero(), "released zero");
+}
+
+void test_geobucket() {
+    check_geobucket<MapTerms>();
+    check_geobucket<VectorTerms>();
+}
+
+template <template <class, class> class Terms>
+void check_multiplication() {
+    std::mt19937 generator(57);
+    for (size_t i = 0; i < 20; ++i) {
+        const auto a = get_random_polynomial<Terms>(generator, 1 + i);
+        const auto b = get_random_polynomial<Terms>(generator, 1 + 2 * i);
+        PolynomialType<Terms> expected;
+        for (const auto& term : b) {
+            expected.subtract_multiple(a, term.first, FieldType() - term.second);
+        }
+        assert_equal(a * b, expected, "heap multiplication");
+        assert_equal(PolynomialType<Terms>::multiply(a, b, 3), expected, "parallel multiplication");
+        assert_equal(PolynomialType<Terms>::multiply(b, a, 64), expected, "more threads than terms");
+    }
+}
+
+void test_multiplication() {
+    check_multiplication<MapTerms>();
+    check_multiplication<VectorTerms>();
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_arithmetic, "Polynomial arithmetic test");
+    runner.run_test(test_storages_agree, "Map and vector storages agree test");
+    runner.run_test(test_geobucket, "Geobucket accumulator test");
+    runner.run_test(test_multiplication, "Heap and parallel multiplication test");
+    return 0;
+}
@@ -0,0 +1,96 @@
+#include "framework/ut.h"
+
+#include "../fields/rational.h"
+
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace math;
+
+std::string to_string(const Rational& value) {
+    std::stringstream out;
+    out << value;
+    return out.str();
+}
+
+void test_small() {
+    Rational zero = 0;
+    Rational one = 1;
+    Rational half = Rational(1) / 2;
+    make_assert(zero.is_zero() && !zero.is_one(), "0 is zero");
+    make_assert(one.is_one() && !one.is_zero(), "1 is one");
+    assert_equal(one + one, Rational(2), "1 + 1 == 2");
+    assert_equal(half + half, one, "1/2 + 1/2 == 1");
+    make_assert((half - half).is_zero(), "1/2 - 1/2 == 0");
+    assert_equal(half * 4, Rational(2), "1/2 * 4 == 2");
+    assert_equal(Rational(3) / Rational(-6), Rational(-1) / 2, "3 / -6 == -1/2");
+    assert_equal(to_string(Rational(-3) / 6), std::string("(-1/2)"), "negative fraction output");
+    assert_equal(to_string(Rational(6) / 3), std::string("2"), "integer output");
+    assert_equal(Rational(RationalType(4) / 6).get_denominator(), IntegerType(3), "GMP value is reduced");
+}
+
+void test_overflow() {
+    const int64_t max = std::numeric_limits<int64_t>::max();
+    Rational big = max;
+    Rational bigger = big + 1;
+    assert_equal(bigger.get_numerator(), IntegerType(max) + 1, "sum overflows into GMP");
+    assert_equal(bigger - 1, big, "difference fits again");
+    make_assert(Rational(std::numeric_limits<int64_t>::min()) + 1 == Rational(-max), "least int64_t");
+    make_assert(Rational(std::numeric_limits<uint64_t>::max()) - Rational(std::numeric_limits<uint64_t>::max()) == Rational(0), "greatest uint64_t");
+    Rational product = big * big;
+    assert_equal(product.get_value(), RationalType(IntegerType(max) * max), "product overflows into GMP");
+    assert_equal(product / big, big, "quotient fits again");
+    assert_equal(Rational(1) / big / big * big, Rational(1) / big, "denominator overflows into GMP");
+}
+
+// The results are compared with GMP for random chains of operations, which overflow from time to time.
+void test_random() {
+    std::mt19937_64 generator(0);
+    std::vector<int64_t> values = {0, 1, -1, 2, 3, 7, 1 << 20, std::numeric_limits<int32_t>::max(), std::numeric_limits<int64_t>::max()};
+    for (size_t round = 0; round < 2000; ++round) {
+        Rational value = 1;
+        RationalType expected = 1;
+        for (size_t step = 0; step < 20; ++step) {
+            int64_t numerator = values[generator() % values.size()];
+            if (generator() % 2) {
+                numerator = -numerator;
+            }
+            const int64_t denominator = std::max<int64_t>(1, values[generator() % values.size()]);
+            const Rational operand = Rational(numerator) / denominator;
+            const RationalType operand_expected = RationalType(IntegerType(numerator), IntegerType(denominator));
+            assert_equal(operand.get_value(), operand_expected, "operand");
+            switch (generator() % 4) {
+                case 0:
+                    value += operand;
+                    expected += operand_expected;
+                    break;
+                case 1:
+                    value -= operand;
+                    expected -= operand_expected;
+                    break;
+                case 2:
+                    value *= operand;
+                    expected *= operand_expected;
+                    break;
+                default:
+                    if (numerator != 0) {
+                        value /= operand;
+                        expected /= operand_expected;
+                    }
+            }
+            assert_equal(value.get_value(), expected, "the same value as GMP");
+            make_assert(value == Rational(expected), "unique representation");
+        }
+    }
+}
+
+int main() {
+    TestRunner runner;
+    runner.run_test(test_small, "Small rationals test");
+    runner.run_test(test_overflow, "Overflow test");
+    runner.run_test(test_random, "Random operations test");
+    return 0;
+}